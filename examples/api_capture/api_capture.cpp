@@ -0,0 +1,957 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#include <imgui.h>
+#include <reshade.hpp>
+#include "api_capture.hpp"
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+
+#ifndef BUILTIN_ADDON
+imgui_function_table g_imgui_function_table;
+#endif
+
+using namespace reshade::api;
+using reshade::addon_event;
+
+namespace
+{
+	std::mutex s_mutex;
+	std::ofstream s_file;
+	reshade::capture::writer s_writer;
+	device *s_device = nullptr;
+	swapchain *s_swapchain = nullptr;
+	std::atomic<bool> s_do_capture = false;
+	uint64_t s_captured_frames = 0;
+	uint64_t s_captured_bytes = 0;
+	// Command lists are identified by the order they were first seen in, since their address is meaningless during replay
+	std::unordered_map<command_list *, uint32_t> s_command_lists;
+	uint32_t s_next_command_list_index = 0;
+
+	// Flush to disk in large chunks, to keep file writes out of the event callbacks as much as possible
+	constexpr size_t FLUSH_THRESHOLD = 16 * 1024 * 1024;
+
+	uint32_t command_list_index(command_list *cmd_list)
+	{
+		if (const auto it = s_command_lists.find(cmd_list); it != s_command_lists.end())
+			return it->second;
+		return s_command_lists.emplace(cmd_list, s_next_command_list_index++).first->second;
+	}
+
+	void flush()
+	{
+		std::vector<uint8_t> &data = s_writer.data();
+		s_file.write(reinterpret_cast<const char *>(data.data()), data.size());
+		s_captured_bytes += data.size();
+		data.clear();
+	}
+
+	struct scoped_record
+	{
+		explicit scoped_record(addon_event type) : lock(s_mutex)
+		{
+			s_writer.begin_record(type);
+		}
+		scoped_record(addon_event type, command_list *cmd_list) : scoped_record(type)
+		{
+			s_writer.write(command_list_index(cmd_list));
+		}
+		~scoped_record()
+		{
+			s_writer.end_record();
+		}
+
+		const std::lock_guard<std::mutex> lock;
+	};
+}
+
+// Object lifetime is always recorded (so that a capture can be started at any point), commands only while capturing
+static inline bool is_captured(device *device)
+{
+	return device == s_device;
+}
+static inline bool is_captured(command_list *cmd_list)
+{
+	return s_do_capture && cmd_list->get_device() == s_device;
+}
+
+static void write_box(const int32_t box[6])
+{
+	s_writer.write<uint8_t>(box != nullptr);
+	for (int i = 0; i < 6; ++i)
+		s_writer.write(box != nullptr ? box[i] : 0);
+}
+static void write_descriptor_update(const descriptor_set_update &update)
+{
+	s_writer.write(update.set);
+	s_writer.write(update.offset);
+	s_writer.write(update.binding);
+	s_writer.write(update.array_offset);
+	s_writer.write(update.count);
+	s_writer.write(update.type);
+
+	switch (update.type)
+	{
+	case descriptor_type::sampler:
+		s_writer.write_bytes(update.descriptors, update.count * sizeof(sampler));
+		break;
+	case descriptor_type::sampler_with_resource_view:
+		s_writer.write_bytes(update.descriptors, update.count * sizeof(sampler_with_resource_view));
+		break;
+	case descriptor_type::shader_resource_view:
+	case descriptor_type::unordered_access_view:
+		s_writer.write_bytes(update.descriptors, update.count * sizeof(resource_view));
+		break;
+	case descriptor_type::constant_buffer:
+		s_writer.write_bytes(update.descriptors, update.count * sizeof(buffer_range));
+		break;
+	}
+}
+
+static void on_init_device(device *device)
+{
+	const std::lock_guard<std::mutex> lock(s_mutex);
+
+	// Only capture the first device, since replay can only reproduce a single one
+	if (s_device != nullptr)
+		return;
+
+	std::filesystem::path capture_path = L"ReShade.capture";
+#ifdef BUILTIN_ADDON
+	reshade::global_config().get("CAPTURE", "Path", capture_path);
+#endif
+
+	s_file.open(capture_path, std::ios::binary | std::ios::trunc);
+	if (!s_file)
+		return;
+
+	s_device = device;
+	s_writer.write(reshade::capture::file_header { reshade::capture::MAGIC, reshade::capture::VERSION, device->get_api() });
+}
+static void on_destroy_device(device *device)
+{
+	const std::lock_guard<std::mutex> lock(s_mutex);
+
+	if (device != s_device)
+		return;
+
+	flush();
+	s_file.close();
+
+	s_device = nullptr;
+	s_swapchain = nullptr;
+	s_do_capture = false;
+	s_command_lists.clear();
+}
+
+static void on_init_command_list(command_list *cmd_list)
+{
+	if (!is_captured(cmd_list->get_device()))
+		return;
+
+	const scoped_record record(addon_event::init_command_list, cmd_list);
+}
+static void on_destroy_command_list(command_list *cmd_list)
+{
+	if (!is_captured(cmd_list->get_device()))
+		return;
+
+	const scoped_record record(addon_event::destroy_command_list, cmd_list);
+	s_command_lists.erase(cmd_list);
+}
+
+static void on_init_swapchain(swapchain *swapchain)
+{
+	if (!is_captured(swapchain->get_device()) || s_swapchain != nullptr)
+		return;
+
+	s_swapchain = swapchain;
+
+	const resource_desc desc = swapchain->get_device()->get_resource_desc(swapchain->get_back_buffer(0));
+
+	const scoped_record record(addon_event::init_swapchain);
+	s_writer.write(desc.texture.width);
+	s_writer.write(desc.texture.height);
+	s_writer.write(desc.texture.format);
+	s_writer.write(swapchain->get_back_buffer_count());
+	for (uint32_t i = 0; i < swapchain->get_back_buffer_count(); ++i)
+		s_writer.write(swapchain->get_back_buffer(i));
+}
+static void on_destroy_swapchain(swapchain *swapchain)
+{
+	if (swapchain != s_swapchain)
+		return;
+
+	s_swapchain = nullptr;
+
+	const scoped_record record(addon_event::destroy_swapchain);
+}
+
+static void on_init_sampler(device *device, const sampler_desc &desc, sampler handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::init_sampler);
+	s_writer.write(desc);
+	s_writer.write(handle);
+}
+static void on_destroy_sampler(device *device, sampler handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::destroy_sampler);
+	s_writer.write(handle);
+}
+static void on_init_resource(device *device, const resource_desc &desc, const subresource_data *initial_data, resource_usage initial_state, resource handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::init_resource);
+	s_writer.write(desc);
+	s_writer.write<uint8_t>(initial_data != nullptr);
+	s_writer.write(initial_state);
+	s_writer.write(handle);
+}
+static void on_destroy_resource(device *device, resource handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::destroy_resource);
+	s_writer.write(handle);
+}
+static void on_init_resource_view(device *device, resource resource, resource_usage usage_type, const resource_view_desc &desc, resource_view handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::init_resource_view);
+	s_writer.write(resource);
+	s_writer.write(usage_type);
+	s_writer.write(desc);
+	s_writer.write(handle);
+}
+static void on_destroy_resource_view(device *device, resource_view handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::destroy_resource_view);
+	s_writer.write(handle);
+}
+static void on_init_pipeline(device *device, const pipeline_desc &desc, pipeline handle)
+{
+	if (!is_captured(device))
+		return;
+
+	// Shader code and pipeline state are not stored, since replay is only concerned with the cost of the calls
+	const scoped_record record(addon_event::init_pipeline);
+	s_writer.write(desc.type);
+	s_writer.write(handle);
+}
+static void on_destroy_pipeline(device *device, pipeline handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::destroy_pipeline);
+	s_writer.write(handle);
+}
+static void on_init_render_pass(device *device, const render_pass_desc &desc, render_pass handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::init_render_pass);
+	s_writer.write(desc);
+	s_writer.write(handle);
+}
+static void on_destroy_render_pass(device *device, render_pass handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::destroy_render_pass);
+	s_writer.write(handle);
+}
+static void on_init_framebuffer(device *device, const framebuffer_desc &desc, framebuffer handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::init_framebuffer);
+	s_writer.write(desc);
+	s_writer.write(handle);
+}
+static void on_destroy_framebuffer(device *device, framebuffer handle)
+{
+	if (!is_captured(device))
+		return;
+
+	const scoped_record record(addon_event::destroy_framebuffer);
+	s_writer.write(handle);
+}
+
+static void on_map_buffer_region(device *device, resource resource, uint64_t offset, uint64_t size, map_access access, void **)
+{
+	if (!is_captured(device) || !s_do_capture)
+		return;
+
+	const scoped_record record(addon_event::map_buffer_region);
+	s_writer.write(resource);
+	s_writer.write(offset);
+	s_writer.write(size);
+	s_writer.write(access);
+}
+static void on_unmap_buffer_region(device *device, resource resource)
+{
+	if (!is_captured(device) || !s_do_capture)
+		return;
+
+	const scoped_record record(addon_event::unmap_buffer_region);
+	s_writer.write(resource);
+}
+static void on_map_texture_region(device *device, resource resource, uint32_t subresource, const int32_t box[6], map_access access, subresource_data *)
+{
+	if (!is_captured(device) || !s_do_capture)
+		return;
+
+	const scoped_record record(addon_event::map_texture_region);
+	s_writer.write(resource);
+	s_writer.write(subresource);
+	write_box(box);
+	s_writer.write(access);
+}
+static void on_unmap_texture_region(device *device, resource resource, uint32_t subresource)
+{
+	if (!is_captured(device) || !s_do_capture)
+		return;
+
+	const scoped_record record(addon_event::unmap_texture_region);
+	s_writer.write(resource);
+	s_writer.write(subresource);
+}
+static bool on_update_buffer_region(device *device, const void *, resource resource, uint64_t offset, uint64_t size)
+{
+	if (!is_captured(device) || !s_do_capture)
+		return false;
+
+	const scoped_record record(addon_event::update_buffer_region);
+	s_writer.write(resource);
+	s_writer.write(offset);
+	s_writer.write(size);
+
+	return false;
+}
+static bool on_update_texture_region(device *device, const subresource_data &data, resource resource, uint32_t subresource, const int32_t box[6])
+{
+	if (!is_captured(device) || !s_do_capture)
+		return false;
+
+	const scoped_record record(addon_event::update_texture_region);
+	s_writer.write(resource);
+	s_writer.write(subresource);
+	write_box(box);
+	s_writer.write(data.row_pitch);
+	s_writer.write(data.slice_pitch);
+
+	return false;
+}
+static bool on_update_descriptor_sets(device *device, uint32_t count, const descriptor_set_update *updates)
+{
+	if (!is_captured(device) || !s_do_capture)
+		return false;
+
+	const scoped_record record(addon_event::update_descriptor_sets);
+	s_writer.write(count);
+	for (uint32_t i = 0; i < count; ++i)
+		write_descriptor_update(updates[i]);
+
+	return false;
+}
+
+static void on_barrier(command_list *cmd_list, uint32_t count, const resource *resources, const resource_usage *old_states, const resource_usage *new_states)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::barrier, cmd_list);
+	s_writer.write_array(resources, count);
+	s_writer.write_array(old_states, count);
+	s_writer.write_array(new_states, count);
+}
+
+static void on_begin_render_pass(command_list *cmd_list, render_pass pass, framebuffer fbo)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::begin_render_pass, cmd_list);
+	s_writer.write(pass);
+	s_writer.write(fbo);
+}
+static void on_finish_render_pass(command_list *cmd_list)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::finish_render_pass, cmd_list);
+}
+static void on_bind_render_targets_and_depth_stencil(command_list *cmd_list, uint32_t count, const resource_view *rtvs, resource_view dsv)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::bind_render_targets_and_depth_stencil, cmd_list);
+	s_writer.write_array(rtvs, count);
+	s_writer.write(dsv);
+}
+
+static void on_bind_pipeline(command_list *cmd_list, pipeline_stage type, pipeline pipeline)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::bind_pipeline, cmd_list);
+	s_writer.write(type);
+	s_writer.write(pipeline);
+}
+static void on_bind_pipeline_states(command_list *cmd_list, uint32_t count, const dynamic_state *states, const uint32_t *values)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::bind_pipeline_states, cmd_list);
+	s_writer.write_array(states, count);
+	s_writer.write_array(values, count);
+}
+static void on_bind_viewports(command_list *cmd_list, uint32_t first, uint32_t count, const float *viewports)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::bind_viewports, cmd_list);
+	s_writer.write(first);
+	s_writer.write_array(viewports, count * 6);
+}
+static void on_bind_scissor_rects(command_list *cmd_list, uint32_t first, uint32_t count, const int32_t *rects)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::bind_scissor_rects, cmd_list);
+	s_writer.write(first);
+	s_writer.write_array(rects, count * 4);
+}
+static void on_push_constants(command_list *cmd_list, shader_stage stages, pipeline_layout layout, uint32_t layout_param, uint32_t first, uint32_t count, const uint32_t *values)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::push_constants, cmd_list);
+	s_writer.write(stages);
+	s_writer.write(layout);
+	s_writer.write(layout_param);
+	s_writer.write(first);
+	s_writer.write_array(values, count);
+}
+static void on_push_descriptors(command_list *cmd_list, shader_stage stages, pipeline_layout layout, uint32_t layout_param, const descriptor_set_update &update)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::push_descriptors, cmd_list);
+	s_writer.write(stages);
+	s_writer.write(layout);
+	s_writer.write(layout_param);
+	write_descriptor_update(update);
+}
+static void on_bind_descriptor_sets(command_list *cmd_list, shader_stage stages, pipeline_layout layout, uint32_t first, uint32_t count, const descriptor_set *sets)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::bind_descriptor_sets, cmd_list);
+	s_writer.write(stages);
+	s_writer.write(layout);
+	s_writer.write(first);
+	s_writer.write_array(sets, count);
+}
+static void on_bind_index_buffer(command_list *cmd_list, resource buffer, uint64_t offset, uint32_t index_size)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::bind_index_buffer, cmd_list);
+	s_writer.write(buffer);
+	s_writer.write(offset);
+	s_writer.write(index_size);
+}
+static void on_bind_vertex_buffers(command_list *cmd_list, uint32_t first, uint32_t count, const resource *buffers, const uint64_t *offsets, const uint32_t *strides)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::bind_vertex_buffers, cmd_list);
+	s_writer.write(first);
+	s_writer.write_array(buffers, count);
+	s_writer.write_array(offsets, count);
+	s_writer.write_array(strides, count);
+}
+
+static bool on_draw(command_list *cmd_list, uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::draw, cmd_list);
+	s_writer.write(vertex_count);
+	s_writer.write(instance_count);
+	s_writer.write(first_vertex);
+	s_writer.write(first_instance);
+
+	return false;
+}
+static bool on_draw_indexed(command_list *cmd_list, uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::draw_indexed, cmd_list);
+	s_writer.write(index_count);
+	s_writer.write(instance_count);
+	s_writer.write(first_index);
+	s_writer.write(vertex_offset);
+	s_writer.write(first_instance);
+
+	return false;
+}
+static bool on_dispatch(command_list *cmd_list, uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::dispatch, cmd_list);
+	s_writer.write(group_count_x);
+	s_writer.write(group_count_y);
+	s_writer.write(group_count_z);
+
+	return false;
+}
+static bool on_draw_or_dispatch_indirect(command_list *cmd_list, indirect_command type, resource buffer, uint64_t offset, uint32_t draw_count, uint32_t stride)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::draw_or_dispatch_indirect, cmd_list);
+	s_writer.write(type);
+	s_writer.write(buffer);
+	s_writer.write(offset);
+	s_writer.write(draw_count);
+	s_writer.write(stride);
+
+	return false;
+}
+
+static bool on_copy_resource(command_list *cmd_list, resource source, resource dest)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::copy_resource, cmd_list);
+	s_writer.write(source);
+	s_writer.write(dest);
+
+	return false;
+}
+static bool on_copy_buffer_region(command_list *cmd_list, resource source, uint64_t source_offset, resource dest, uint64_t dest_offset, uint64_t size)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::copy_buffer_region, cmd_list);
+	s_writer.write(source);
+	s_writer.write(source_offset);
+	s_writer.write(dest);
+	s_writer.write(dest_offset);
+	s_writer.write(size);
+
+	return false;
+}
+static bool on_copy_buffer_to_texture(command_list *cmd_list, resource source, uint64_t source_offset, uint32_t row_length, uint32_t slice_height, resource dest, uint32_t dest_subresource, const int32_t dest_box[6])
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::copy_buffer_to_texture, cmd_list);
+	s_writer.write(source);
+	s_writer.write(source_offset);
+	s_writer.write(row_length);
+	s_writer.write(slice_height);
+	s_writer.write(dest);
+	s_writer.write(dest_subresource);
+	write_box(dest_box);
+
+	return false;
+}
+static bool on_copy_texture_region(command_list *cmd_list, resource source, uint32_t source_subresource, const int32_t source_box[6], resource dest, uint32_t dest_subresource, const int32_t dest_box[6], filter_mode filter)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::copy_texture_region, cmd_list);
+	s_writer.write(source);
+	s_writer.write(source_subresource);
+	write_box(source_box);
+	s_writer.write(dest);
+	s_writer.write(dest_subresource);
+	write_box(dest_box);
+	s_writer.write(filter);
+
+	return false;
+}
+static bool on_copy_texture_to_buffer(command_list *cmd_list, resource source, uint32_t source_subresource, const int32_t source_box[6], resource dest, uint64_t dest_offset, uint32_t row_length, uint32_t slice_height)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::copy_texture_to_buffer, cmd_list);
+	s_writer.write(source);
+	s_writer.write(source_subresource);
+	write_box(source_box);
+	s_writer.write(dest);
+	s_writer.write(dest_offset);
+	s_writer.write(row_length);
+	s_writer.write(slice_height);
+
+	return false;
+}
+static bool on_resolve_texture_region(command_list *cmd_list, resource source, uint32_t source_subresource, const int32_t source_box[6], resource dest, uint32_t dest_subresource, const int32_t dest_offset[3], format format)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::resolve_texture_region, cmd_list);
+	s_writer.write(source);
+	s_writer.write(source_subresource);
+	write_box(source_box);
+	s_writer.write(dest);
+	s_writer.write(dest_subresource);
+	s_writer.write<uint8_t>(dest_offset != nullptr);
+	for (int i = 0; i < 3; ++i)
+		s_writer.write(dest_offset != nullptr ? dest_offset[i] : 0);
+	s_writer.write(format);
+
+	return false;
+}
+
+static bool on_clear_attachments(command_list *cmd_list, attachment_type clear_flags, const float color[4], float depth, uint8_t stencil, uint32_t rect_count, const int32_t *rects)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::clear_attachments, cmd_list);
+	s_writer.write(clear_flags);
+	for (int i = 0; i < 4; ++i)
+		s_writer.write(color != nullptr ? color[i] : 0.0f);
+	s_writer.write(depth);
+	s_writer.write(stencil);
+	s_writer.write_array(rects, rect_count * 4);
+
+	return false;
+}
+static bool on_clear_depth_stencil_view(command_list *cmd_list, resource_view dsv, attachment_type clear_flags, float depth, uint8_t stencil, uint32_t rect_count, const int32_t *rects)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::clear_depth_stencil_view, cmd_list);
+	s_writer.write(dsv);
+	s_writer.write(clear_flags);
+	s_writer.write(depth);
+	s_writer.write(stencil);
+	s_writer.write_array(rects, rect_count * 4);
+
+	return false;
+}
+static bool on_clear_render_target_view(command_list *cmd_list, resource_view rtv, const float color[4], uint32_t rect_count, const int32_t *rects)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::clear_render_target_view, cmd_list);
+	s_writer.write(rtv);
+	s_writer.write_bytes(color, 4 * sizeof(float));
+	s_writer.write_array(rects, rect_count * 4);
+
+	return false;
+}
+static bool on_clear_unordered_access_view_uint(command_list *cmd_list, resource_view uav, const uint32_t values[4], uint32_t rect_count, const int32_t *rects)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::clear_unordered_access_view_uint, cmd_list);
+	s_writer.write(uav);
+	s_writer.write_bytes(values, 4 * sizeof(uint32_t));
+	s_writer.write_array(rects, rect_count * 4);
+
+	return false;
+}
+static bool on_clear_unordered_access_view_float(command_list *cmd_list, resource_view uav, const float values[4], uint32_t rect_count, const int32_t *rects)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::clear_unordered_access_view_float, cmd_list);
+	s_writer.write(uav);
+	s_writer.write_bytes(values, 4 * sizeof(float));
+	s_writer.write_array(rects, rect_count * 4);
+
+	return false;
+}
+
+static bool on_generate_mipmaps(command_list *cmd_list, resource_view srv)
+{
+	if (!is_captured(cmd_list))
+		return false;
+
+	const scoped_record record(addon_event::generate_mipmaps, cmd_list);
+	s_writer.write(srv);
+
+	return false;
+}
+
+static void on_reset_command_list(command_list *cmd_list)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::reset_command_list, cmd_list);
+}
+static void on_execute_command_list(command_queue *queue, command_list *cmd_list)
+{
+	if (!s_do_capture || queue->get_device() != s_device)
+		return;
+
+	const scoped_record record(addon_event::execute_command_list, cmd_list);
+}
+static void on_execute_secondary_command_list(command_list *cmd_list, command_list *secondary_cmd_list)
+{
+	if (!is_captured(cmd_list))
+		return;
+
+	const scoped_record record(addon_event::execute_secondary_command_list, cmd_list);
+	s_writer.write(command_list_index(secondary_cmd_list));
+}
+
+static void on_present(command_queue *, swapchain *swapchain)
+{
+	if (swapchain != s_swapchain || !s_do_capture)
+		return;
+
+	{
+		const scoped_record record(addon_event::present);
+		s_captured_frames++;
+	}
+
+	const std::lock_guard<std::mutex> lock(s_mutex);
+	if (s_writer.data().size() >= FLUSH_THRESHOLD)
+		flush();
+}
+
+static void draw_overlay(effect_runtime *, void *)
+{
+	if (s_device == nullptr)
+	{
+		ImGui::TextUnformatted("Failed to open capture file for writing.");
+		return;
+	}
+
+	if (!s_do_capture)
+	{
+		if (ImGui::Button("Start Capture"))
+			s_do_capture = true;
+	}
+	else
+	{
+		if (ImGui::Button("Stop Capture"))
+		{
+			s_do_capture = false;
+
+			const std::lock_guard<std::mutex> lock(s_mutex);
+			flush();
+			s_file.flush();
+		}
+	}
+
+	ImGui::Text("Captured %llu frames (%llu KiB)", s_captured_frames, (s_captured_bytes + s_writer.data().size()) / 1024);
+}
+
+void register_addon_api_capture()
+{
+	reshade::register_overlay("API Capture", draw_overlay);
+
+	reshade::register_event<addon_event::init_device>(on_init_device);
+	reshade::register_event<addon_event::destroy_device>(on_destroy_device);
+	reshade::register_event<addon_event::init_command_list>(on_init_command_list);
+	reshade::register_event<addon_event::destroy_command_list>(on_destroy_command_list);
+	reshade::register_event<addon_event::init_swapchain>(on_init_swapchain);
+	reshade::register_event<addon_event::destroy_swapchain>(on_destroy_swapchain);
+	reshade::register_event<addon_event::init_sampler>(on_init_sampler);
+	reshade::register_event<addon_event::destroy_sampler>(on_destroy_sampler);
+	reshade::register_event<addon_event::init_resource>(on_init_resource);
+	reshade::register_event<addon_event::destroy_resource>(on_destroy_resource);
+	reshade::register_event<addon_event::init_resource_view>(on_init_resource_view);
+	reshade::register_event<addon_event::destroy_resource_view>(on_destroy_resource_view);
+	reshade::register_event<addon_event::init_pipeline>(on_init_pipeline);
+	reshade::register_event<addon_event::destroy_pipeline>(on_destroy_pipeline);
+	reshade::register_event<addon_event::init_render_pass>(on_init_render_pass);
+	reshade::register_event<addon_event::destroy_render_pass>(on_destroy_render_pass);
+	reshade::register_event<addon_event::init_framebuffer>(on_init_framebuffer);
+	reshade::register_event<addon_event::destroy_framebuffer>(on_destroy_framebuffer);
+
+	reshade::register_event<addon_event::map_buffer_region>(on_map_buffer_region);
+	reshade::register_event<addon_event::unmap_buffer_region>(on_unmap_buffer_region);
+	reshade::register_event<addon_event::map_texture_region>(on_map_texture_region);
+	reshade::register_event<addon_event::unmap_texture_region>(on_unmap_texture_region);
+	reshade::register_event<addon_event::update_buffer_region>(on_update_buffer_region);
+	reshade::register_event<addon_event::update_texture_region>(on_update_texture_region);
+	reshade::register_event<addon_event::update_descriptor_sets>(on_update_descriptor_sets);
+
+	reshade::register_event<addon_event::barrier>(on_barrier);
+	reshade::register_event<addon_event::begin_render_pass>(on_begin_render_pass);
+	reshade::register_event<addon_event::finish_render_pass>(on_finish_render_pass);
+	reshade::register_event<addon_event::bind_render_targets_and_depth_stencil>(on_bind_render_targets_and_depth_stencil);
+	reshade::register_event<addon_event::bind_pipeline>(on_bind_pipeline);
+	reshade::register_event<addon_event::bind_pipeline_states>(on_bind_pipeline_states);
+	reshade::register_event<addon_event::bind_viewports>(on_bind_viewports);
+	reshade::register_event<addon_event::bind_scissor_rects>(on_bind_scissor_rects);
+	reshade::register_event<addon_event::push_constants>(on_push_constants);
+	reshade::register_event<addon_event::push_descriptors>(on_push_descriptors);
+	reshade::register_event<addon_event::bind_descriptor_sets>(on_bind_descriptor_sets);
+	reshade::register_event<addon_event::bind_index_buffer>(on_bind_index_buffer);
+	reshade::register_event<addon_event::bind_vertex_buffers>(on_bind_vertex_buffers);
+	reshade::register_event<addon_event::draw>(on_draw);
+	reshade::register_event<addon_event::draw_indexed>(on_draw_indexed);
+	reshade::register_event<addon_event::dispatch>(on_dispatch);
+	reshade::register_event<addon_event::draw_or_dispatch_indirect>(on_draw_or_dispatch_indirect);
+	reshade::register_event<addon_event::copy_resource>(on_copy_resource);
+	reshade::register_event<addon_event::copy_buffer_region>(on_copy_buffer_region);
+	reshade::register_event<addon_event::copy_buffer_to_texture>(on_copy_buffer_to_texture);
+	reshade::register_event<addon_event::copy_texture_region>(on_copy_texture_region);
+	reshade::register_event<addon_event::copy_texture_to_buffer>(on_copy_texture_to_buffer);
+	reshade::register_event<addon_event::resolve_texture_region>(on_resolve_texture_region);
+	reshade::register_event<addon_event::clear_attachments>(on_clear_attachments);
+	reshade::register_event<addon_event::clear_depth_stencil_view>(on_clear_depth_stencil_view);
+	reshade::register_event<addon_event::clear_render_target_view>(on_clear_render_target_view);
+	reshade::register_event<addon_event::clear_unordered_access_view_uint>(on_clear_unordered_access_view_uint);
+	reshade::register_event<addon_event::clear_unordered_access_view_float>(on_clear_unordered_access_view_float);
+	reshade::register_event<addon_event::generate_mipmaps>(on_generate_mipmaps);
+
+	reshade::register_event<addon_event::reset_command_list>(on_reset_command_list);
+	reshade::register_event<addon_event::execute_command_list>(on_execute_command_list);
+	reshade::register_event<addon_event::execute_secondary_command_list>(on_execute_secondary_command_list);
+
+	reshade::register_event<addon_event::present>(on_present);
+}
+void unregister_addon_api_capture()
+{
+	reshade::unregister_overlay("API Capture");
+
+	reshade::unregister_event<addon_event::init_device>(on_init_device);
+	reshade::unregister_event<addon_event::destroy_device>(on_destroy_device);
+	reshade::unregister_event<addon_event::init_command_list>(on_init_command_list);
+	reshade::unregister_event<addon_event::destroy_command_list>(on_destroy_command_list);
+	reshade::unregister_event<addon_event::init_swapchain>(on_init_swapchain);
+	reshade::unregister_event<addon_event::destroy_swapchain>(on_destroy_swapchain);
+	reshade::unregister_event<addon_event::init_sampler>(on_init_sampler);
+	reshade::unregister_event<addon_event::destroy_sampler>(on_destroy_sampler);
+	reshade::unregister_event<addon_event::init_resource>(on_init_resource);
+	reshade::unregister_event<addon_event::destroy_resource>(on_destroy_resource);
+	reshade::unregister_event<addon_event::init_resource_view>(on_init_resource_view);
+	reshade::unregister_event<addon_event::destroy_resource_view>(on_destroy_resource_view);
+	reshade::unregister_event<addon_event::init_pipeline>(on_init_pipeline);
+	reshade::unregister_event<addon_event::destroy_pipeline>(on_destroy_pipeline);
+	reshade::unregister_event<addon_event::init_render_pass>(on_init_render_pass);
+	reshade::unregister_event<addon_event::destroy_render_pass>(on_destroy_render_pass);
+	reshade::unregister_event<addon_event::init_framebuffer>(on_init_framebuffer);
+	reshade::unregister_event<addon_event::destroy_framebuffer>(on_destroy_framebuffer);
+
+	reshade::unregister_event<addon_event::map_buffer_region>(on_map_buffer_region);
+	reshade::unregister_event<addon_event::unmap_buffer_region>(on_unmap_buffer_region);
+	reshade::unregister_event<addon_event::map_texture_region>(on_map_texture_region);
+	reshade::unregister_event<addon_event::unmap_texture_region>(on_unmap_texture_region);
+	reshade::unregister_event<addon_event::update_buffer_region>(on_update_buffer_region);
+	reshade::unregister_event<addon_event::update_texture_region>(on_update_texture_region);
+	reshade::unregister_event<addon_event::update_descriptor_sets>(on_update_descriptor_sets);
+
+	reshade::unregister_event<addon_event::barrier>(on_barrier);
+	reshade::unregister_event<addon_event::begin_render_pass>(on_begin_render_pass);
+	reshade::unregister_event<addon_event::finish_render_pass>(on_finish_render_pass);
+	reshade::unregister_event<addon_event::bind_render_targets_and_depth_stencil>(on_bind_render_targets_and_depth_stencil);
+	reshade::unregister_event<addon_event::bind_pipeline>(on_bind_pipeline);
+	reshade::unregister_event<addon_event::bind_pipeline_states>(on_bind_pipeline_states);
+	reshade::unregister_event<addon_event::bind_viewports>(on_bind_viewports);
+	reshade::unregister_event<addon_event::bind_scissor_rects>(on_bind_scissor_rects);
+	reshade::unregister_event<addon_event::push_constants>(on_push_constants);
+	reshade::unregister_event<addon_event::push_descriptors>(on_push_descriptors);
+	reshade::unregister_event<addon_event::bind_descriptor_sets>(on_bind_descriptor_sets);
+	reshade::unregister_event<addon_event::bind_index_buffer>(on_bind_index_buffer);
+	reshade::unregister_event<addon_event::bind_vertex_buffers>(on_bind_vertex_buffers);
+	reshade::unregister_event<addon_event::draw>(on_draw);
+	reshade::unregister_event<addon_event::draw_indexed>(on_draw_indexed);
+	reshade::unregister_event<addon_event::dispatch>(on_dispatch);
+	reshade::unregister_event<addon_event::draw_or_dispatch_indirect>(on_draw_or_dispatch_indirect);
+	reshade::unregister_event<addon_event::copy_resource>(on_copy_resource);
+	reshade::unregister_event<addon_event::copy_buffer_region>(on_copy_buffer_region);
+	reshade::unregister_event<addon_event::copy_buffer_to_texture>(on_copy_buffer_to_texture);
+	reshade::unregister_event<addon_event::copy_texture_region>(on_copy_texture_region);
+	reshade::unregister_event<addon_event::copy_texture_to_buffer>(on_copy_texture_to_buffer);
+	reshade::unregister_event<addon_event::resolve_texture_region>(on_resolve_texture_region);
+	reshade::unregister_event<addon_event::clear_attachments>(on_clear_attachments);
+	reshade::unregister_event<addon_event::clear_depth_stencil_view>(on_clear_depth_stencil_view);
+	reshade::unregister_event<addon_event::clear_render_target_view>(on_clear_render_target_view);
+	reshade::unregister_event<addon_event::clear_unordered_access_view_uint>(on_clear_unordered_access_view_uint);
+	reshade::unregister_event<addon_event::clear_unordered_access_view_float>(on_clear_unordered_access_view_float);
+	reshade::unregister_event<addon_event::generate_mipmaps>(on_generate_mipmaps);
+
+	reshade::unregister_event<addon_event::reset_command_list>(on_reset_command_list);
+	reshade::unregister_event<addon_event::execute_command_list>(on_execute_command_list);
+	reshade::unregister_event<addon_event::execute_secondary_command_list>(on_execute_secondary_command_list);
+
+	reshade::unregister_event<addon_event::present>(on_present);
+}
+
+#ifdef _WINDLL
+
+extern "C" __declspec(dllexport) const char *NAME = "API Capture";
+extern "C" __declspec(dllexport) const char *DESCRIPTION = "Example add-on that records all graphics API calls into a binary file, which can be replayed with the test application.";
+
+BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)
+{
+	switch (fdwReason)
+	{
+	case DLL_PROCESS_ATTACH:
+		if (!reshade::register_addon(hModule))
+			return FALSE;
+		register_addon_api_capture();
+		break;
+	case DLL_PROCESS_DETACH:
+		unregister_addon_api_capture();
+		reshade::unregister_addon(hModule);
+		break;
+	}
+
+	return TRUE;
+}
+
+#endif
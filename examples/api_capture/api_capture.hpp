@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#pragma once
+
+#include <reshade_events.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace reshade::capture
+{
+	/// <summary>
+	/// Identifies a capture file ("RSCP").
+	/// </summary>
+	constexpr uint32_t MAGIC = 0x50435352;
+	/// <summary>
+	/// Version of the capture file format, which has to be increased whenever the layout of a record changes.
+	/// </summary>
+	constexpr uint32_t VERSION = 1;
+
+	/// <summary>
+	/// Header at the start of a capture file.
+	/// </summary>
+	struct file_header
+	{
+		uint32_t magic;
+		uint32_t version;
+		api::device_api device_api;
+	};
+
+	/// <summary>
+	/// Header in front of every record in a capture file, which is followed by <see cref="size"/> bytes of event arguments.
+	/// Events are identified by their add-on event value, so a record is written for every event that was observed and read back in the same order when replaying it.
+	/// Handles are stored with their original value (and have to be translated during replay), command lists are stored as an index that is assigned in order of appearance.
+	/// Content of resources (like initial data or data passed to update and map operations) is not stored, only its size.
+	/// </summary>
+	struct record_header
+	{
+		addon_event type;
+		uint32_t size;
+	};
+
+	/// <summary>
+	/// Serializes event arguments into a memory buffer.
+	/// </summary>
+	class writer
+	{
+	public:
+		void begin_record(addon_event type)
+		{
+			_record_offset = _data.size();
+			write(record_header { type, 0 });
+		}
+		void end_record()
+		{
+			const uint32_t size = static_cast<uint32_t>(_data.size() - _record_offset - sizeof(record_header));
+			std::memcpy(_data.data() + _record_offset + offsetof(record_header, size), &size, sizeof(size));
+		}
+
+		template <typename T>
+		void write(const T &value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			write_bytes(&value, sizeof(T));
+		}
+		template <typename T>
+		void write_array(const T *values, uint32_t count)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			write(count);
+			if (values != nullptr)
+				write_bytes(values, count * sizeof(T));
+			else
+				_data.resize(_data.size() + count * sizeof(T));
+		}
+		void write_bytes(const void *data, size_t size)
+		{
+			_data.insert(_data.end(), static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + size);
+		}
+
+		std::vector<uint8_t> &data() { return _data; }
+
+	private:
+		std::vector<uint8_t> _data;
+		size_t _record_offset = 0;
+	};
+
+	/// <summary>
+	/// Deserializes event arguments from a memory buffer written by <see cref="writer"/>.
+	/// </summary>
+	class reader
+	{
+	public:
+		reader(const uint8_t *data, size_t size) : _data(data), _end(data + size) {}
+
+		bool at_end() const { return _data >= _end; }
+		bool overflowed() const { return _overflow; }
+
+		template <typename T>
+		T read()
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			T value = {};
+			if (const uint8_t *const data = read_bytes(sizeof(T)); data != nullptr)
+				std::memcpy(&value, data, sizeof(T));
+			return value;
+		}
+		/// <summary>
+		/// Reads an array written by <see cref="writer::write_array"/>.
+		/// The elements are copied out, since they are not necessarily aligned in the capture data.
+		/// </summary>
+		template <typename T>
+		std::vector<T> read_array()
+		{
+			const uint32_t count = read<uint32_t>();
+			// Check the count against the remaining data before allocating, so that a corrupted capture cannot cause a huge allocation
+			if (!check_count(count, sizeof(T)))
+				return {};
+
+			std::vector<T> values(count);
+			if (const uint8_t *const data = read_bytes(count * sizeof(T)); data != nullptr && count != 0)
+				std::memcpy(values.data(), data, count * sizeof(T));
+			return values;
+		}
+		const uint8_t *read_bytes(size_t size)
+		{
+			if (static_cast<size_t>(_end - _data) < size)
+			{
+				invalidate();
+				return nullptr;
+			}
+
+			const uint8_t *const data = _data;
+			_data += size;
+			return data;
+		}
+
+		/// <summary>
+		/// Checks that the remaining data can hold the specified number of elements, so that a count read from the capture can be validated before allocating memory for it.
+		/// Marks the reader as overflowed if that is not the case, the same as reading past the end does.
+		/// </summary>
+		bool check_count(uint64_t count, size_t element_size)
+		{
+			// Dividing instead of multiplying avoids an overflow of the size calculation
+			if (count > static_cast<size_t>(_end - _data) / element_size)
+			{
+				invalidate();
+				return false;
+			}
+			return true;
+		}
+		/// <summary>
+		/// Marks the reader as overflowed, for values that were read successfully but are not valid.
+		/// </summary>
+		void invalidate()
+		{
+			_overflow = true;
+			_data = _end;
+		}
+
+	private:
+		const uint8_t *_data, *_end;
+		bool _overflow = false;
+	};
+}
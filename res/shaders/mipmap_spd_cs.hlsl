@@ -0,0 +1,132 @@
+SamplerState s0 : register(s0);
+Texture2D<float4> t0 : register(t0);
+// Destination mipmap levels 1 to 12, unused levels are bound to null views
+globallycoherent RWTexture2D<float4> dest[12] : register(u0);
+// Number of thread groups that finished the first six levels
+globallycoherent RWByteAddressBuffer counter : register(u12);
+// Level 6 results of all thread groups, which the last group reads to build the remaining levels
+globallycoherent RWStructuredBuffer<float4> level6 : register(u13);
+
+cbuffer cb0 : register(b0)
+{
+	float2 texel; // 1.0 / dimension of level 0
+	uint num_levels; // Number of mipmap levels to generate (excluding level 0)
+	uint num_groups_x;
+	uint num_groups_y;
+}
+
+groupshared float4 tile[16][16];
+groupshared bool is_last_group;
+
+// Reduces the 16x16 values in the shared tile down to a single one, writing the four levels starting at the specified destination
+void downsample_tile(uint2 tid, uint2 group, const uint first_dest, bool write)
+{
+	[unroll]
+	for (uint i = 0, size = 8; i < 4; ++i, size /= 2)
+	{
+		float4 value = 0;
+		if (all(tid < size))
+			value = (tile[tid.y * 2][tid.x * 2] + tile[tid.y * 2][tid.x * 2 + 1] + tile[tid.y * 2 + 1][tid.x * 2] + tile[tid.y * 2 + 1][tid.x * 2 + 1]) * 0.25;
+
+		GroupMemoryBarrierWithGroupSync();
+
+		if (all(tid < size))
+		{
+			tile[tid.y][tid.x] = value;
+
+			if (write && first_dest + i < num_levels)
+				dest[first_dest + i][group * size + tid] = value;
+		}
+
+		GroupMemoryBarrierWithGroupSync();
+	}
+}
+
+[numthreads(16, 16, 1)]
+void main(uint3 gid : SV_GroupID, uint3 gtid : SV_GroupThreadID, uint gindex : SV_GroupIndex)
+{
+	// Every thread group handles a 64x64 tile of level 0, each thread builds a 2x2 block of level 1 from it
+	float4 value = 0;
+	[unroll]
+	for (uint y = 0; y < 2; ++y)
+	{
+		[unroll]
+		for (uint x = 0; x < 2; ++x)
+		{
+			const uint2 pos = gid.xy * 32 + gtid.xy * 2 + uint2(x, y);
+
+			// Linear filtering averages the 2x2 texels of level 0 that make up this texel of level 1
+			const float4 color = t0.SampleLevel(s0, texel * (pos * 2 + 1), 0);
+			dest[0][pos] = color;
+			value += color;
+		}
+	}
+
+	// Out of bounds writes are discarded, so no need to check the size of each level
+	value *= 0.25;
+	if (num_levels > 1)
+		dest[1][gid.xy * 16 + gtid.xy] = value;
+
+	tile[gtid.y][gtid.x] = value;
+	GroupMemoryBarrierWithGroupSync();
+
+	// Levels 3 to 6
+	downsample_tile(gtid.xy, gid.xy, 2, true);
+
+	if (num_levels <= 6)
+		return;
+
+	// Only the last thread group to get here continues with the remaining levels, which depend on the results of all groups
+	if (gindex == 0)
+	{
+		level6[gid.y * num_groups_x + gid.x] = tile[0][0];
+		DeviceMemoryBarrier();
+
+		uint num_finished_groups = 0;
+		counter.InterlockedAdd(0, 1, num_finished_groups);
+		is_last_group = num_finished_groups == (num_groups_x * num_groups_y - 1);
+	}
+
+	GroupMemoryBarrierWithGroupSync();
+
+	// Synchronization has to happen in uniform flow control, so all groups go through the rest, but only the last one writes anything
+	const bool write = is_last_group;
+
+	// Reset counter for the next dispatch
+	if (write && gindex == 0)
+		counter.Store(0, 0);
+
+	// Level 6 is at most 64x64 (for a 4096x4096 level 0), so each thread builds a 2x2 block of level 7 from it
+	value = 0;
+	[unroll]
+	for (uint y = 0; y < 2; ++y)
+	{
+		[unroll]
+		for (uint x = 0; x < 2; ++x)
+		{
+			const uint2 pos = gtid.xy * 2 + uint2(x, y);
+
+			float4 color = 0;
+			[unroll]
+			for (uint j = 0; j < 2; ++j)
+				[unroll]
+				for (uint i = 0; i < 2; ++i)
+					color += level6[min(pos.y * 2 + j, num_groups_y - 1) * num_groups_x + min(pos.x * 2 + i, num_groups_x - 1)];
+			color *= 0.25;
+
+			if (write)
+				dest[6][pos] = color;
+			value += color;
+		}
+	}
+
+	value *= 0.25;
+	if (write && num_levels > 7)
+		dest[7][gtid.xy] = value;
+
+	tile[gtid.y][gtid.x] = value;
+	GroupMemoryBarrierWithGroupSync();
+
+	// Levels 9 to 12
+	downsample_tile(gtid.xy, uint2(0, 0), 8, write);
+}
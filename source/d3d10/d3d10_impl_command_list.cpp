@@ -411,17 +411,20 @@ void reshade::d3d10::device_impl::resolve_texture_region(api::resource src, uint
 
 void reshade::d3d10::device_impl::clear_attachments(api::attachment_type clear_flags, const float color[4], float depth, uint8_t stencil, uint32_t rect_count, const int32_t *)
 {
-	assert(rect_count == 0);
-
 	com_ptr<ID3D10DepthStencilView> dsv;
 	com_ptr<ID3D10RenderTargetView> rtv[D3D10_SIMULTANEOUS_RENDER_TARGET_COUNT];
 	_orig->OMGetRenderTargets(ARRAYSIZE(rtv), reinterpret_cast<ID3D10RenderTargetView **>(rtv), &dsv);
 
-	if (static_cast<UINT>(clear_flags & (api::attachment_type::color)) != 0)
+	// D3D10 cannot clear only parts of a render target, so skip the clear instead of discarding everything outside the rectangles
+	if (static_cast<UINT>(clear_flags & (api::attachment_type::color)) != 0 && rect_count == 0)
 		for (UINT i = 0; i < ARRAYSIZE(rtv) && rtv[i] != nullptr; ++i)
 			_orig->ClearRenderTargetView(rtv[i].get(), color);
 	if (static_cast<UINT>(clear_flags & (api::attachment_type::depth | api::attachment_type::stencil)) != 0 && dsv != nullptr)
+	{
+		assert(rect_count == 0);
+
 		_orig->ClearDepthStencilView(dsv.get(), static_cast<UINT>(clear_flags) >> 1, depth, stencil);
+	}
 }
 void reshade::d3d10::device_impl::clear_depth_stencil_view(api::resource_view dsv, api::attachment_type clear_flags, float depth, uint8_t stencil, uint32_t rect_count, const int32_t *)
 {
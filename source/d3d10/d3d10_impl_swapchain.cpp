@@ -134,6 +134,28 @@ void reshade::d3d10::swapchain_impl::on_present()
 	ID3D10Device *const immediate_context = static_cast<device_impl *>(_graphics_queue)->_orig;
 	_app_state.capture();
 
+	// Timestamp queries count ticks of a frequency that is only available from a disjoint query, so determine it once
+	if (!_has_timestamp_frequency)
+	{
+		_has_timestamp_frequency = true;
+
+		const D3D10_QUERY_DESC query_desc = { D3D10_QUERY_TIMESTAMP_DISJOINT };
+		if (com_ptr<ID3D10Query> disjoint_query;
+			SUCCEEDED(immediate_context->CreateQuery(&query_desc, &disjoint_query)))
+		{
+			disjoint_query->Begin();
+			disjoint_query->End();
+
+			HRESULT hr;
+			D3D10_QUERY_DATA_TIMESTAMP_DISJOINT disjoint_data;
+			while ((hr = disjoint_query->GetData(&disjoint_data, sizeof(disjoint_data), 0)) == S_FALSE)
+				Sleep(0);
+
+			if (hr == S_OK && disjoint_data.Frequency != 0)
+				_timestamp_period = 1e9 / disjoint_data.Frequency;
+		}
+	}
+
 	// Resolve MSAA back buffer if MSAA is active
 	if (_backbuffer_resolved != _backbuffer)
 		immediate_context->ResolveSubresource(_backbuffer_resolved.get(), 0, _backbuffer.get(), 0, convert_format(_backbuffer_format));
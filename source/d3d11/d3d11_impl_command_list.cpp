@@ -543,19 +543,33 @@ void reshade::d3d11::device_context_impl::resolve_texture_region(api::resource s
 		reinterpret_cast<ID3D11Resource *>(src.handle), src_subresource, convert_format(format));
 }
 
-void reshade::d3d11::device_context_impl::clear_attachments(api::attachment_type clear_flags, const float color[4], float depth, uint8_t stencil, uint32_t rect_count, const int32_t *)
+void reshade::d3d11::device_context_impl::clear_attachments(api::attachment_type clear_flags, const float color[4], float depth, uint8_t stencil, uint32_t rect_count, const int32_t *rects)
 {
-	assert(rect_count == 0);
-
 	com_ptr<ID3D11DepthStencilView> dsv;
 	com_ptr<ID3D11RenderTargetView> rtv[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
 	_orig->OMGetRenderTargets(ARRAYSIZE(rtv), reinterpret_cast<ID3D11RenderTargetView **>(rtv), &dsv);
 
 	if (static_cast<UINT>(clear_flags & (api::attachment_type::color)) != 0)
-		for (UINT i = 0; i < ARRAYSIZE(rtv) && rtv[i] != nullptr; ++i)
-			_orig->ClearRenderTargetView(rtv[i].get(), color);
+	{
+		if (rect_count == 0)
+		{
+			for (UINT i = 0; i < ARRAYSIZE(rtv) && rtv[i] != nullptr; ++i)
+				_orig->ClearRenderTargetView(rtv[i].get(), color);
+		}
+		// Clearing only parts of a render target requires D3D11.1, so skip the clear when that is not available instead of discarding everything outside the rectangles
+		else if (com_ptr<ID3D11DeviceContext1> context1;
+			SUCCEEDED(_orig->QueryInterface(&context1)))
+		{
+			for (UINT i = 0; i < ARRAYSIZE(rtv) && rtv[i] != nullptr; ++i)
+				context1->ClearView(rtv[i].get(), color, reinterpret_cast<const D3D11_RECT *>(rects), rect_count);
+		}
+	}
 	if (static_cast<UINT>(clear_flags & (api::attachment_type::depth | api::attachment_type::stencil)) != 0 && dsv != nullptr)
+	{
+		assert(rect_count == 0);
+
 		_orig->ClearDepthStencilView(dsv.get(), static_cast<UINT>(clear_flags) >> 1, depth, stencil);
+	}
 }
 void reshade::d3d11::device_context_impl::clear_depth_stencil_view(api::resource_view dsv, api::attachment_type clear_flags, float depth, uint8_t stencil, uint32_t rect_count, const int32_t *)
 {
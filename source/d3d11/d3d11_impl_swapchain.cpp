@@ -151,6 +151,28 @@ void reshade::d3d11::swapchain_impl::on_present()
 	ID3D11DeviceContext *const immediate_context = static_cast<device_context_impl *>(_graphics_queue)->_orig;
 	_app_state.capture(immediate_context);
 
+	// Timestamp queries count ticks of a frequency that is only available from a disjoint query, so determine it once
+	if (!_has_timestamp_frequency)
+	{
+		_has_timestamp_frequency = true;
+
+		const D3D11_QUERY_DESC query_desc = { D3D11_QUERY_TIMESTAMP_DISJOINT };
+		if (com_ptr<ID3D11Query> disjoint_query;
+			SUCCEEDED(static_cast<device_impl *>(_device)->_orig->CreateQuery(&query_desc, &disjoint_query)))
+		{
+			immediate_context->Begin(disjoint_query.get());
+			immediate_context->End(disjoint_query.get());
+
+			HRESULT hr;
+			D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint_data;
+			while ((hr = immediate_context->GetData(disjoint_query.get(), &disjoint_data, sizeof(disjoint_data), 0)) == S_FALSE)
+				Sleep(0);
+
+			if (hr == S_OK && disjoint_data.Frequency != 0)
+				_timestamp_period = 1e9 / disjoint_data.Frequency;
+		}
+	}
+
 	// Resolve MSAA back buffer if MSAA is active
 	if (_backbuffer_resolved != _backbuffer)
 		immediate_context->ResolveSubresource(_backbuffer_resolved.get(), 0, _backbuffer.get(), 0, convert_format(_backbuffer_format));
@@ -39,5 +39,6 @@ namespace reshade::d3d11
 		com_ptr<ID3D11Texture2D> _backbuffer_resolved;
 		com_ptr<ID3D11RenderTargetView> _backbuffer_rtv;
 		com_ptr<ID3D11ShaderResourceView> _backbuffer_resolved_srv;
+		bool _has_timestamp_frequency = false;
 	};
 }
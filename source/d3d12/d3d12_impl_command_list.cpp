@@ -623,6 +623,11 @@ void reshade::d3d12::command_list_impl::generate_mipmaps(api::resource_view srv)
 
 	const D3D12_RESOURCE_DESC desc = resource->GetDesc();
 
+	// Generate all levels in a single dispatch where possible, which is limited to 12 levels below a 4096x4096 level 0
+	if (_device_impl->_mipmap_spd_pipeline != nullptr && desc.MipLevels > 1 && desc.MipLevels <= 13 && desc.Width <= 4096 && desc.Height <= 4096 &&
+		generate_mipmaps_single_pass(resource, desc))
+		return;
+
 	D3D12_CPU_DESCRIPTOR_HANDLE base_handle;
 	D3D12_GPU_DESCRIPTOR_HANDLE base_handle_gpu;
 	if (!_device_impl->_gpu_view_heap.allocate_transient(desc.MipLevels * 2, base_handle, base_handle_gpu))
@@ -658,6 +663,8 @@ void reshade::d3d12::command_list_impl::generate_mipmaps(api::resource_view srv)
 
 	_orig->SetComputeRootSignature(_device_impl->_mipmap_signature.get());
 	_orig->SetPipelineState(_device_impl->_mipmap_pipeline.get());
+	// Keep track of the root signature change, so that 'bind_descriptor_sets' does not skip setting it again afterwards
+	_current_root_signature[1] = _device_impl->_mipmap_signature.get();
 
 	D3D12_RESOURCE_BARRIER transition = { D3D12_RESOURCE_BARRIER_TYPE_TRANSITION };
 	transition.Transition.pResource = resource;
@@ -695,6 +702,130 @@ void reshade::d3d12::command_list_impl::generate_mipmaps(api::resource_view srv)
 		_orig->SetDescriptorHeaps(_current_descriptor_heaps[1] != nullptr ? 2 : 1, _current_descriptor_heaps);
 }
 
+bool reshade::d3d12::command_list_impl::generate_mipmaps_single_pass(ID3D12Resource *resource, const D3D12_RESOURCE_DESC &desc)
+{
+	if (_mipmap_spd_counter == nullptr)
+	{
+		// Committed resources are zero-initialized, which is the state the shader expects the counter in (it resets it again itself at the end of a dispatch)
+		// Buffers are promoted to the unordered access state implicitly on first use, so can be created in the common state
+		D3D12_HEAP_PROPERTIES heap_props = { D3D12_HEAP_TYPE_DEFAULT };
+		D3D12_RESOURCE_DESC buffer_desc = { D3D12_RESOURCE_DIMENSION_BUFFER };
+		buffer_desc.Width = 64 * 64 * 4 * sizeof(float);
+		buffer_desc.Height = 1;
+		buffer_desc.DepthOrArraySize = 1;
+		buffer_desc.MipLevels = 1;
+		buffer_desc.SampleDesc = { 1, 0 };
+		buffer_desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		buffer_desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+
+		if (FAILED(_device_impl->_orig->CreateCommittedResource(&heap_props, D3D12_HEAP_FLAG_NONE, &buffer_desc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&_mipmap_spd_level6))) ||
+			(buffer_desc.Width = sizeof(uint32_t), FAILED(_device_impl->_orig->CreateCommittedResource(&heap_props, D3D12_HEAP_FLAG_NONE, &buffer_desc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&_mipmap_spd_counter)))))
+		{
+			_mipmap_spd_level6.reset();
+			return false;
+		}
+	}
+
+	// One view for level 0, followed by 12 views for the destination levels and the two helper buffers
+	D3D12_CPU_DESCRIPTOR_HANDLE base_handle;
+	D3D12_GPU_DESCRIPTOR_HANDLE base_handle_gpu;
+	if (!_device_impl->_gpu_view_heap.allocate_transient(1 + 12 + 2, base_handle, base_handle_gpu))
+		return true;
+
+	const UINT descriptor_size = _device_impl->_descriptor_handle_size[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV];
+	const DXGI_FORMAT view_format = convert_format(api::format_to_default_typed(convert_format(desc.Format)));
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srv_desc;
+	srv_desc.Format = view_format;
+	srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srv_desc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srv_desc.Texture2D.MipLevels = 1;
+	srv_desc.Texture2D.MostDetailedMip = 0;
+	srv_desc.Texture2D.PlaneSlice = 0;
+	srv_desc.Texture2D.ResourceMinLODClamp = 0.0f;
+
+	_device_impl->_orig->CreateShaderResourceView(resource, &srv_desc, base_handle);
+	base_handle.ptr += descriptor_size;
+
+	for (uint32_t level = 1; level <= 12; ++level, base_handle.ptr += descriptor_size)
+	{
+		D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc;
+		uav_desc.Format = view_format;
+		uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+		uav_desc.Texture2D.MipSlice = level;
+		uav_desc.Texture2D.PlaneSlice = 0;
+
+		// All descriptors in the table have to be valid, so use null views for levels the texture does not have
+		_device_impl->_orig->CreateUnorderedAccessView(level < desc.MipLevels ? resource : nullptr, nullptr, &uav_desc, base_handle);
+	}
+
+	{
+		D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc = {};
+		uav_desc.Format = DXGI_FORMAT_R32_TYPELESS;
+		uav_desc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+		uav_desc.Buffer.NumElements = 1;
+		uav_desc.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_RAW;
+
+		_device_impl->_orig->CreateUnorderedAccessView(_mipmap_spd_counter.get(), nullptr, &uav_desc, base_handle);
+		base_handle.ptr += descriptor_size;
+
+		uav_desc.Format = DXGI_FORMAT_UNKNOWN;
+		uav_desc.Buffer.NumElements = 64 * 64;
+		uav_desc.Buffer.StructureByteStride = 4 * sizeof(float);
+		uav_desc.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_NONE;
+
+		_device_impl->_orig->CreateUnorderedAccessView(_mipmap_spd_level6.get(), nullptr, &uav_desc, base_handle);
+	}
+
+	const auto view_heap = _device_impl->_gpu_view_heap.get();
+	if (_current_descriptor_heaps[0] != view_heap && _current_descriptor_heaps[1] != view_heap)
+		_orig->SetDescriptorHeaps(1, &view_heap);
+
+	_orig->SetComputeRootSignature(_device_impl->_mipmap_spd_signature.get());
+	_orig->SetPipelineState(_device_impl->_mipmap_spd_pipeline.get());
+	_current_root_signature[1] = _device_impl->_mipmap_spd_signature.get();
+
+	const uint32_t width = static_cast<uint32_t>(desc.Width);
+	const uint32_t height = desc.Height;
+
+	// Every thread group handles a 64x64 tile of level 0
+	const uint32_t num_groups_x = (width + 63) / 64;
+	const uint32_t num_groups_y = (height + 63) / 64;
+
+	struct { float texel[2]; uint32_t num_levels, num_groups_x, num_groups_y; } constants = {
+		{ 1.0f / width, 1.0f / height }, desc.MipLevels - 1u, num_groups_x, num_groups_y };
+	_orig->SetComputeRoot32BitConstants(0, 5, &constants, 0);
+	_orig->SetComputeRootDescriptorTable(1, base_handle_gpu);
+	_orig->SetComputeRootDescriptorTable(2, { base_handle_gpu.ptr + descriptor_size });
+
+	// Level 0 stays readable, only the levels that are written need to be transitioned
+	// The helper buffers may still be in use by a previous dispatch, so also wait for all unordered accesses to finish
+	D3D12_RESOURCE_BARRIER barriers[13];
+	for (uint32_t level = 1; level < desc.MipLevels; ++level)
+	{
+		barriers[level - 1] = { D3D12_RESOURCE_BARRIER_TYPE_TRANSITION };
+		barriers[level - 1].Transition.pResource = resource;
+		barriers[level - 1].Transition.Subresource = level;
+		barriers[level - 1].Transition.StateBefore = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+		barriers[level - 1].Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+	}
+	barriers[desc.MipLevels - 1] = { D3D12_RESOURCE_BARRIER_TYPE_UAV };
+	barriers[desc.MipLevels - 1].UAV.pResource = nullptr;
+	_orig->ResourceBarrier(desc.MipLevels, barriers);
+
+	_orig->Dispatch(num_groups_x, num_groups_y, 1);
+
+	for (uint32_t level = 1; level < desc.MipLevels; ++level)
+		std::swap(barriers[level - 1].Transition.StateBefore, barriers[level - 1].Transition.StateAfter);
+	_orig->ResourceBarrier(desc.MipLevels - 1, barriers);
+
+	// Reset descriptor heaps
+	if (_current_descriptor_heaps[0] != view_heap && _current_descriptor_heaps[1] != view_heap && _current_descriptor_heaps[0] != nullptr)
+		_orig->SetDescriptorHeaps(_current_descriptor_heaps[1] != nullptr ? 2 : 1, _current_descriptor_heaps);
+
+	return true;
+}
+
 void reshade::d3d12::command_list_impl::begin_query(api::query_pool pool, api::query_type type, uint32_t index)
 {
 	_has_commands = true;
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <d3d12.h>
+#include "com_ptr.hpp"
 #include "addon_manager.hpp"
 
 namespace reshade::d3d12
@@ -67,6 +68,8 @@ namespace reshade::d3d12
 		void insert_debug_marker(const char *label, const float color[4]) final;
 
 	protected:
+		bool generate_mipmaps_single_pass(ID3D12Resource *resource, const D3D12_RESOURCE_DESC &desc);
+
 		device_impl *const _device_impl;
 		bool _has_commands = false;
 
@@ -76,5 +79,9 @@ namespace reshade::d3d12
 		ID3D12DescriptorHeap *_current_descriptor_heaps[2] = {};
 
 		struct framebuffer_impl *_current_fbo;
+
+		// Helper buffers of the single pass mipmap generation, which are separate for every command list, so that command lists executing concurrently (e.g. on different queues) do not race on them
+		com_ptr<ID3D12Resource> _mipmap_spd_counter;
+		com_ptr<ID3D12Resource> _mipmap_spd_level6;
 	};
 }
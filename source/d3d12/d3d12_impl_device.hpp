@@ -136,5 +136,8 @@ namespace reshade::d3d12
 
 		com_ptr<ID3D12PipelineState> _mipmap_pipeline;
 		com_ptr<ID3D12RootSignature> _mipmap_signature;
+		// Generates up to 12 mipmap levels in a single dispatch (see 'command_list_impl::generate_mipmaps')
+		com_ptr<ID3D12PipelineState> _mipmap_spd_pipeline;
+		com_ptr<ID3D12RootSignature> _mipmap_spd_signature;
 	};
 }
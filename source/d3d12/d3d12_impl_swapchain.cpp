@@ -34,6 +34,10 @@ reshade::d3d12::swapchain_impl::swapchain_impl(device_impl *device, command_queu
 		}
 	}
 
+	if (UINT64 frequency = 0;
+		SUCCEEDED(queue->_orig->GetTimestampFrequency(&frequency)) && frequency != 0)
+		_timestamp_period = 1e9 / frequency;
+
 	// Default to three back buffers for d3d12on7
 	_backbuffers.resize(3);
 
@@ -121,6 +121,14 @@ std::filesystem::path get_module_path(HMODULE module)
 #  include <D3D12Downlevel.h>
 #  include <GL/gl3w.h>
 #  include <vulkan/vulkan.h>
+#  include <new>
+#  include <atomic>
+#  include <thread>
+#  include "log_histogram.hpp"
+#  include "null/null_impl_device.hpp"
+#  include "null/null_impl_command_queue.hpp"
+#  include "null/null_impl_swapchain.hpp"
+#  include "null/null_replay.hpp"
 
 #  define HR_CHECK(exp) { const HRESULT res = (exp); assert(SUCCEEDED(res)); }
 #  define VK_CHECK(exp) { const VkResult res = (exp); assert(res == VK_SUCCESS); }
@@ -129,6 +137,111 @@ std::filesystem::path get_module_path(HMODULE module)
 #  define VK_CALL_DEVICE(name, device, ...) reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name))(device, __VA_ARGS__)
 #  define VK_CALL_INSTANCE(name, instance, ...) reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(instance, #name))(__VA_ARGS__)
 
+// Count every heap allocation made in the process, so that the null device mode can report how many allocations the runtime makes per frame
+static std::atomic<uint64_t> s_alloc_count = 0;
+static std::atomic<uint64_t> s_alloc_bytes = 0;
+
+static void *counted_malloc(size_t size) noexcept
+{
+	s_alloc_count++;
+	s_alloc_bytes += size;
+
+	return std::malloc(size != 0 ? size : 1);
+}
+static void *counted_aligned_malloc(size_t size, std::align_val_t alignment) noexcept
+{
+	s_alloc_count++;
+	s_alloc_bytes += size;
+
+	return _aligned_malloc(size != 0 ? size : 1, static_cast<size_t>(alignment));
+}
+
+void *operator new(size_t size)
+{
+	if (void *const ptr = counted_malloc(size))
+		return ptr;
+	throw std::bad_alloc();
+}
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	return counted_malloc(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return counted_malloc(size);
+}
+void *operator new(size_t size, std::align_val_t alignment)
+{
+	if (void *const ptr = counted_aligned_malloc(size, alignment))
+		return ptr;
+	throw std::bad_alloc();
+}
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return counted_aligned_malloc(size, alignment);
+}
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return counted_aligned_malloc(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+void operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+void operator delete(void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+void operator delete[](void *ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+	std::free(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+	std::free(ptr);
+}
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+	_aligned_free(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+	_aligned_free(ptr);
+}
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+	_aligned_free(ptr);
+}
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept
+{
+	_aligned_free(ptr);
+}
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+	_aligned_free(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept
+{
+	_aligned_free(ptr);
+}
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow)
 {
 	g_module_handle = hInstance;
@@ -817,6 +930,166 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR lpCmdLine, int nCmdShow
 	}
 	#pragma endregion
 
+	#pragma region Null Implementation
+	if (strstr(lpCmdLine, "-null"))
+	{
+		// Measures the CPU overhead of the runtime without any driver involved, using the effects and preset from the configuration
+		uint32_t num_frames = 1000;
+		if (const char *frames_arg = strstr(lpCmdLine, "-frames "))
+			num_frames = std::max(1, atoi(frames_arg + 8));
+
+		reshade::null::device_impl device;
+		reshade::null::command_queue_impl queue(&device);
+
+		int exit_code = EXIT_SUCCESS;
+		if (const char *replay_arg = strstr(lpCmdLine, "-replay "))
+		{
+			// Replays a capture of an application recorded with the API capture add-on, so that it can be profiled without having the application at hand
+			const std::string capture_path(replay_arg + 8, strcspn(replay_arg + 8, " "));
+
+			reshade::log_histogram frame_times;
+			const auto time_replay_started = std::chrono::high_resolution_clock::now();
+
+			if (reshade::null::replay_capture(capture_path, &device, &queue, window_handle, frame_times))
+			{
+				const auto time_replay_finished = std::chrono::high_resolution_clock::now();
+
+				LOG(INFO) << "Replayed " << frame_times.count() << " frames in " << std::chrono::duration_cast<std::chrono::milliseconds>(time_replay_finished - time_replay_started).count() << " ms:";
+				LOG(INFO) << "  Frame time: p50 " << (frame_times.percentile(50) / 1000) << " us, p99 " << (frame_times.percentile(99) / 1000) << " us";
+				LOG(INFO) << "API calls per frame:";
+				for (const auto &[name, count] : device.get_call_counts())
+					LOG(INFO) << "  " << name << ": " << (static_cast<double>(count) / std::max<uint64_t>(1, frame_times.count()));
+			}
+			else
+			{
+				exit_code = EXIT_FAILURE;
+			}
+		}
+		else
+		{
+			reshade::null::swapchain_impl swapchain(&device, &queue, 1920, 1080, reshade::api::format::r8g8b8a8_unorm);
+
+			const auto time_load_started = std::chrono::high_resolution_clock::now();
+
+			if (!swapchain.on_init(window_handle))
+				return EXIT_FAILURE;
+
+			// Effects are loaded in the background, so keep presenting until that finished
+			while (swapchain.is_loading())
+			{
+				swapchain.on_present();
+				std::this_thread::yield();
+			}
+
+			const auto time_load_finished = std::chrono::high_resolution_clock::now();
+
+			LOG(INFO) << "Loading effects took " << std::chrono::duration_cast<std::chrono::milliseconds>(time_load_finished - time_load_started).count() << " ms, with " << device.get_allocation_count() << " objects and " << (device.get_allocation_size() / (1024 * 1024)) << " MiB of resources created.";
+
+			device.reset_statistics();
+
+			reshade::api::resource_view rtv = {};
+			device.create_resource_view(swapchain.get_back_buffer(0), reshade::api::resource_usage::render_target, reshade::api::resource_view_desc(reshade::api::format::r8g8b8a8_unorm), &rtv);
+
+			const uint64_t alloc_count_before = s_alloc_count;
+			const uint64_t alloc_bytes_before = s_alloc_bytes;
+
+			// Render effects separately before presenting (like an add-on would), so that the time spent in it can be measured independently of the updates done in 'on_present'
+			reshade::log_histogram render_times, present_times;
+			for (uint32_t i = 0; i < num_frames; ++i)
+			{
+				const auto time_render_started = std::chrono::high_resolution_clock::now();
+				swapchain.render_effects(queue.get_immediate_command_list(), rtv);
+				const auto time_present_started = std::chrono::high_resolution_clock::now();
+				swapchain.on_present();
+				const auto time_present_finished = std::chrono::high_resolution_clock::now();
+
+				render_times.record(std::chrono::duration_cast<std::chrono::nanoseconds>(time_present_started - time_render_started).count());
+				present_times.record(std::chrono::duration_cast<std::chrono::nanoseconds>(time_present_finished - time_present_started).count());
+			}
+
+			LOG(INFO) << "Rendered " << num_frames << " frames:";
+			LOG(INFO) << "  render_effects: p50 " << (render_times.percentile(50) / 1000) << " us, p99 " << (render_times.percentile(99) / 1000) << " us";
+			LOG(INFO) << "  on_present:     p50 " << (present_times.percentile(50) / 1000) << " us, p99 " << (present_times.percentile(99) / 1000) << " us";
+			LOG(INFO) << "  " << (static_cast<double>(s_alloc_count - alloc_count_before) / num_frames) << " heap allocations per frame (" << ((s_alloc_bytes - alloc_bytes_before) / num_frames) << " bytes)";
+			LOG(INFO) << "  " << device.get_allocation_count() << " API objects created (" << (device.get_allocation_size() / 1024) << " KiB)";
+			LOG(INFO) << "API calls per frame:";
+			for (const auto &[name, count] : device.get_call_counts())
+				LOG(INFO) << "  " << name << ": " << (static_cast<double>(count) / num_frames);
+
+#if RESHADE_GUI
+			if (strstr(lpCmdLine, "-check-timings"))
+			{
+				// Verify that the per-pass GPU timings and the exported trace match, using timestamps that advance by a fixed step with every query
+				constexpr uint64_t timestamp_step = 1000;
+				device.set_timestamp_step(timestamp_step);
+				swapchain.set_record_gpu_timings(true);
+
+				// Query results are read back three frames later and averaged over 60 frames, so render enough frames to fill that average
+				for (uint32_t i = 0; i < 64; ++i)
+				{
+					swapchain.render_effects(queue.get_immediate_command_list(), rtv);
+					swapchain.on_present();
+				}
+
+				swapchain.set_record_gpu_timings(false);
+				device.set_timestamp_step(0);
+
+				const std::vector<std::pair<std::string, uint64_t>> pass_durations = swapchain.get_pass_gpu_durations();
+				const std::string trace = swapchain.get_trace_json();
+
+				// Every event is written on a separate line, starting with its name
+				std::vector<std::pair<std::string, double>> pass_events;
+				for (size_t offset = 0; (offset = trace.find("\n{\"name\":\"", offset)) != std::string::npos; ++offset)
+				{
+					const size_t line_end = trace.find('\n', offset + 1);
+					const std::string line = trace.substr(offset + 10, line_end - offset - 10);
+					if (line.find("\"cat\":\"pass\"") == std::string::npos || line.find("\"pid\":2") == std::string::npos)
+						continue;
+
+					const size_t dur_offset = line.find("\"dur\":");
+					pass_events.emplace_back(line.substr(0, line.find('\"')), dur_offset != std::string::npos ? std::strtod(line.c_str() + dur_offset + 6, nullptr) : 0.0);
+				}
+
+				// The last frame of the trace contains one event for every pass, in the same order as the technique list
+				if (pass_events.size() < pass_durations.size())
+				{
+					LOG(ERROR) << "Trace contains " << pass_events.size() << " GPU pass events, but expected at least " << pass_durations.size() << '!';
+					exit_code = EXIT_FAILURE;
+				}
+				else
+				{
+					for (size_t i = 0, event_index = pass_events.size() - pass_durations.size(); i < pass_durations.size(); ++i, ++event_index)
+					{
+						const auto &[name, duration] = pass_durations[i];
+
+						if (duration != timestamp_step || pass_events[event_index].first != name || pass_events[event_index].second != duration * 1e-3)
+						{
+							LOG(ERROR) << "GPU timing of pass \"" << name << "\" is " << duration << " ns (" << pass_events[event_index].second << " us in trace), but expected " << timestamp_step << " ns!";
+							exit_code = EXIT_FAILURE;
+						}
+					}
+
+					if (exit_code == EXIT_SUCCESS)
+						LOG(INFO) << "GPU timings of " << pass_durations.size() << " passes match the trace.";
+				}
+			}
+#endif
+
+			device.destroy_resource_view(rtv);
+		}
+
+		if (device.get_live_object_count() != 0)
+		{
+			LOG(ERROR) << "Runtime leaked " << device.get_live_object_count() << " objects!";
+			exit_code = EXIT_FAILURE;
+		}
+
+		reshade::hooks::uninstall();
+
+		return exit_code;
+	}
+	#pragma endregion
+
 	return EXIT_FAILURE;
 }
 
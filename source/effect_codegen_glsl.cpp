@@ -38,6 +38,8 @@ private:
 	};
 
 	std::string _ubo_block;
+	std::string _shared_uniform_names[std::size(shared_uniform_slots)];
+	bool _uses_shared_uniforms = false;
 	std::string _compute_block;
 	std::unordered_map<id, std::string> _names;
 	std::unordered_map<id, std::string> _blocks;
@@ -100,6 +102,24 @@ private:
 			// TODO: This technically only works with square matrices
 			module.hlsl += "layout(std140, column_major, binding = 0) uniform _Globals {\n" + _ubo_block + "};\n";
 
+		if (_uses_shared_uniforms)
+		{
+			// Always declare every slot, so that the std140 layout matches the layout the runtime fills in
+			module.hlsl += "layout(std140, binding = 1) uniform _Shared {\n";
+			for (size_t i = 0; i < std::size(shared_uniform_slots); ++i)
+			{
+				type type = {};
+				type.base = shared_uniform_slots[i].base;
+				type.rows = shared_uniform_slots[i].rows;
+				type.cols = 1;
+
+				module.hlsl += '\t';
+				write_type(module.hlsl, type);
+				module.hlsl += ' ' + (_shared_uniform_names[i].empty() ? "_shared_" + std::to_string(i) : _shared_uniform_names[i]) + ";\n";
+			}
+			module.hlsl += "};\n";
+		}
+
 		module.hlsl += _blocks.at(0);
 	}
 
@@ -529,6 +549,19 @@ private:
 
 			_module.spec_constants.push_back(info);
 		}
+		else if (const int slot_index = find_shared_uniform_slot(info);
+			slot_index >= 0 && _shared_uniform_names[slot_index].empty())
+		{
+			// Values that are the same for all effects are read from the shared uniform block instead
+			info.size = info.type.rows * 4;
+			info.offset = shared_uniform_slots[slot_index].offset;
+			info.in_shared_block = true;
+
+			_shared_uniform_names[slot_index] = id_to_name(res);
+			_uses_shared_uniforms = true;
+
+			_module.uniforms.push_back(info);
+		}
 		else
 		{
 			// GLSL specification on std140 layout:
@@ -37,6 +37,8 @@ private:
 
 	std::string _cbuffer_block;
 	std::string _current_location;
+	std::string _shared_uniform_names[std::size(shared_uniform_slots)];
+	bool _uses_shared_uniforms = false;
 	std::unordered_map<id, std::string> _names;
 	std::unordered_map<id, std::string> _blocks;
 	bool _debug_info = false;
@@ -56,6 +58,24 @@ private:
 
 			if (!_cbuffer_block.empty())
 				module.hlsl += "cbuffer _Globals {\n" + _cbuffer_block + "};\n";
+
+			if (_uses_shared_uniforms)
+			{
+				// Always declare every slot, so that the packing matches the layout the runtime fills in
+				module.hlsl += "cbuffer _Shared : register(b1) {\n";
+				for (size_t i = 0; i < std::size(shared_uniform_slots); ++i)
+				{
+					type type = {};
+					type.base = shared_uniform_slots[i].base;
+					type.rows = shared_uniform_slots[i].rows;
+					type.cols = 1;
+
+					module.hlsl += '\t';
+					write_type(module.hlsl, type);
+					module.hlsl += ' ' + (_shared_uniform_names[i].empty() ? "_shared_" + std::to_string(i) : _shared_uniform_names[i]) + ";\n";
+				}
+				module.hlsl += "};\n";
+			}
 		}
 		else
 		{
@@ -527,6 +547,19 @@ private:
 
 			_module.spec_constants.push_back(info);
 		}
+		else if (const int slot_index = _shader_model >= 40 ? find_shared_uniform_slot(info) : -1;
+			slot_index >= 0 && _shared_uniform_names[slot_index].empty())
+		{
+			// Values that are the same for all effects are read from the shared constant buffer instead (which shader model 3 does not have)
+			info.size = info.type.rows * 4;
+			info.offset = shared_uniform_slots[slot_index].offset;
+			info.in_shared_block = true;
+
+			_shared_uniform_names[slot_index] = id_to_name(res);
+			_uses_shared_uniforms = true;
+
+			_module.uniforms.push_back(info);
+		}
 		else
 		{
 			if (info.type.is_matrix())
@@ -184,6 +184,9 @@ private:
 	id _global_ubo_type = 0;
 	id _global_ubo_variable = 0;
 	std::vector<spv::Id> _global_ubo_types;
+	id _shared_ubo_type = 0;
+	id _shared_ubo_variable = 0;
+	bool _shared_uniform_used[std::size(shared_uniform_slots)] = {};
 	function_blocks *_current_function = nullptr;
 
 	inline void add_location(const location &loc, spirv_basic_block &block)
@@ -255,6 +258,34 @@ private:
 
 			add_name(variable_inst.result, "$Globals");
 		}
+		if (_shared_ubo_type != 0)
+		{
+			// Always declare every slot, so that the layout matches the layout the runtime fills in
+			std::vector<spv::Id> member_types;
+			for (uint32_t member_index = 0; member_index < std::size(shared_uniform_slots); ++member_index)
+			{
+				type member_type = {};
+				// Boolean values are stored as integers, same as in the global uniform buffer
+				member_type.base = shared_uniform_slots[member_index].base == type::t_bool ? type::t_uint : shared_uniform_slots[member_index].base;
+				member_type.rows = shared_uniform_slots[member_index].rows;
+				member_type.cols = 1;
+
+				member_types.push_back(convert_type(member_type, false, spv::StorageClassUniform));
+
+				add_member_decoration(_shared_ubo_type, member_index, spv::DecorationOffset, { shared_uniform_slots[member_index].offset });
+			}
+
+			spirv_instruction &type_inst = add_instruction_without_result(spv::OpTypeStruct, _types_and_constants);
+			type_inst.add(member_types.begin(), member_types.end());
+			type_inst.result = _shared_ubo_type;
+
+			spirv_instruction &variable_inst = add_instruction_without_result(spv::OpVariable, _variables);
+			variable_inst.add(spv::StorageClassUniform);
+			variable_inst.type = convert_type({ type::t_struct, 0, 0, type::q_uniform, 0, _shared_ubo_type }, true, spv::StorageClassUniform);
+			variable_inst.result = _shared_ubo_variable;
+
+			add_name(variable_inst.result, "$Shared");
+		}
 
 		module = std::move(_module);
 
@@ -778,6 +809,36 @@ private:
 
 			return res;
 		}
+		else if (const int slot_index = find_shared_uniform_slot(info);
+			slot_index >= 0 && !_shared_uniform_used[slot_index])
+		{
+			// Values that are the same for all effects are read from the shared uniform buffer instead, which is created on demand as well
+			if (_shared_ubo_type == 0)
+			{
+				_shared_ubo_type = make_id();
+
+				add_decoration(_shared_ubo_type, spv::DecorationBlock);
+			}
+			if (_shared_ubo_variable == 0)
+			{
+				_shared_ubo_variable = make_id();
+
+				add_decoration(_shared_ubo_variable, spv::DecorationDescriptorSet, { 0 });
+				add_decoration(_shared_ubo_variable, spv::DecorationBinding, { 1 });
+			}
+
+			info.size = info.type.rows * 4;
+			info.offset = shared_uniform_slots[slot_index].offset;
+			info.in_shared_block = true;
+
+			_shared_uniform_used[slot_index] = true;
+
+			add_member_name(_shared_ubo_type, static_cast<uint32_t>(slot_index), info.name.c_str());
+
+			_module.uniforms.push_back(info);
+
+			return 0xE0000000 | static_cast<uint32_t>(slot_index);
+		}
 		else
 		{
 			// Create global uniform buffer variable on demand
@@ -1275,7 +1336,9 @@ private:
 			// Check if this is a uniform variable (see 'define_uniform' function above) and dereference it
 			if (result & 0xF0000000)
 			{
-				const uint32_t member_index = result ^ 0xF0000000;
+				// Members of the shared uniform buffer are tagged differently from those of the global one
+				const bool is_shared = (result & 0xF0000000) == 0xE0000000;
+				const uint32_t member_index = result & 0x0FFFFFFF;
 
 				storage = spv::StorageClassUniform;
 				is_uniform_bool = base_type.is_boolean();
@@ -1284,7 +1347,7 @@ private:
 					base_type.base = type::t_uint;
 
 				access_chain = &add_instruction(spv::OpAccessChain)
-					.add(_global_ubo_variable)
+					.add(is_shared ? _shared_ubo_variable : _global_ubo_variable)
 					.add(emit_constant(member_index));
 			}
 
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "effect_expression.hpp"
+#include <algorithm>
 #include <unordered_set>
 
 namespace reshadefx
@@ -223,8 +224,62 @@ namespace reshadefx
 		std::vector<annotation> annotations;
 		bool has_initializer_value = false;
 		reshadefx::constant initializer_value;
+		bool in_shared_block = false;
 	};
 
+	/// <summary>
+	/// A slot in the constant block that is shared between all effects and holds values that are the same for every effect (like the frame time).
+	/// Uniforms with a matching "source" annotation and type are placed in this block instead of the per-effect uniform storage.
+	/// </summary>
+	struct shared_uniform_slot
+	{
+		const char *source;
+		const char *source_alias;
+		reshadefx::type::datatype base;
+		unsigned int rows;
+		uint32_t offset;
+	};
+
+	/// <summary>
+	/// Layout of the shared constant block. Offsets follow both HLSL and GLSL std140 packing rules.
+	/// </summary>
+	inline constexpr shared_uniform_slot shared_uniform_slots[] = {
+		{ "frametime", nullptr, type::t_float, 1, 0 },
+		{ "timer", nullptr, type::t_float, 1, 4 },
+		{ "framecount", nullptr, type::t_int, 1, 8 },
+		{ "framecount", nullptr, type::t_uint, 1, 12 },
+		{ "date", nullptr, type::t_float, 4, 16 },
+		{ "date", nullptr, type::t_int, 4, 32 },
+		{ "mousepoint", nullptr, type::t_float, 2, 48 },
+		{ "overlay_open", "ui_open", type::t_bool, 1, 56 },
+	};
+	inline constexpr uint32_t shared_uniform_block_size = 64;
+
+	/// <summary>
+	/// Finds the slot in the shared constant block the specified uniform can be placed in.
+	/// </summary>
+	/// <returns>Index of the matching slot, or -1 if this uniform has to be stored per effect.</returns>
+	inline int find_shared_uniform_slot(const uniform_info &info)
+	{
+		if (info.type.is_array() || info.type.cols != 1)
+			return -1;
+
+		const auto source_it = std::find_if(info.annotations.begin(), info.annotations.end(),
+			[](const annotation &annotation) { return annotation.name == "source"; });
+		if (source_it == info.annotations.end() || source_it->type.base != type::t_string)
+			return -1;
+
+		for (int i = 0; i < static_cast<int>(std::size(shared_uniform_slots)); ++i)
+		{
+			const shared_uniform_slot &slot = shared_uniform_slots[i];
+			if (info.type.base == slot.base && info.type.rows == slot.rows &&
+				(source_it->value.string_data == slot.source || (slot.source_alias != nullptr && source_it->value.string_data == slot.source_alias)))
+				return i;
+		}
+
+		return -1;
+	}
+
 	/// <summary>
 	/// Type of a shader entry point.
 	/// </summary>
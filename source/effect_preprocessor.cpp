@@ -63,7 +63,7 @@ static const int precedence_lookup[] = {
 	11, 11, 11, 11 // unary operators
 };
 
-static bool read_file(const std::filesystem::path &path, std::string &data)
+static bool read_file_from_disk(const std::filesystem::path &path, std::string &data)
 {
 #ifdef _WIN32
 	FILE *file = nullptr;
@@ -105,6 +105,27 @@ static std::string escape_string(std::string s)
 	return '\"' + s + '\"';
 }
 
+bool reshadefx::preprocessor::include_cache::read(const std::filesystem::path &path, std::string &data)
+{
+	const std::string key = path.u8string();
+
+	{ const std::unique_lock<std::mutex> lock(_mutex);
+		if (const auto it = _files.find(key); it != _files.end())
+		{
+			data = it->second;
+			return true;
+		}
+	}
+
+	// Read outside the lock, so that other threads are not blocked on disk access (in the rare case two threads read the same file at once, both simply read it)
+	if (!read_file_from_disk(path, data))
+		return false;
+
+	const std::unique_lock<std::mutex> lock(_mutex);
+	_files.emplace(key, data);
+	return true;
+}
+
 reshadefx::preprocessor::preprocessor()
 {
 }
@@ -123,6 +144,14 @@ bool reshadefx::preprocessor::add_macro_definition(const std::string &name, cons
 	return _macros.emplace(name, macro).second;
 }
 
+bool reshadefx::preprocessor::read_file(const std::filesystem::path &path, std::string &data)
+{
+	if (_include_cache != nullptr)
+		return _include_cache->read(path, data);
+
+	return read_file_from_disk(path, data);
+}
+
 bool reshadefx::preprocessor::append_file(const std::filesystem::path &path)
 {
 	std::string data;
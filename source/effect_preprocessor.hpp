@@ -6,6 +6,7 @@
 #pragma once
 
 #include "effect_token.hpp"
+#include <mutex>
 #include <memory> // std::unique_ptr
 #include <filesystem>
 #include <unordered_map>
@@ -27,6 +28,25 @@ namespace reshadefx
 			bool is_function_like = false;
 		};
 
+		/// <summary>
+		/// A cache of file contents that can be shared between multiple preprocessor instances (including ones running on different threads), so that files included by many inputs are only read from disk once.
+		/// </summary>
+		class include_cache
+		{
+		public:
+			/// <summary>
+			/// Get the contents of the specified file, reading it from disk only if it is not in the cache yet.
+			/// </summary>
+			/// <param name="path">The path to the file to read.</param>
+			/// <param name="data">The string that receives the file contents.</param>
+			/// <returns>A boolean value indicating whether the file could be read or not.</returns>
+			bool read(const std::filesystem::path &path, std::string &data);
+
+		private:
+			std::mutex _mutex;
+			std::unordered_map<std::string, std::string> _files;
+		};
+
 		// Define constructor explicitly because lexer class is not included here
 		preprocessor();
 		~preprocessor();
@@ -36,6 +56,11 @@ namespace reshadefx
 		/// </summary>
 		/// <param name="path">The path to the directory to add.</param>
 		void add_include_path(const std::filesystem::path &path);
+		/// <summary>
+		/// Read files through the specified cache instead of directly from disk. The cache has to outlive this preprocessor instance.
+		/// </summary>
+		/// <param name="cache">The cache to use, or <see langword="nullptr"/> to read files from disk again.</param>
+		void set_include_cache(include_cache *cache) { _include_cache = cache; }
 
 		/// <summary>
 		/// Add a new macro definition. This is equal to appending '#define name macro' to this preprocessor instance.
@@ -109,6 +134,8 @@ namespace reshadefx
 		void error(const location &location, const std::string &message);
 		void warning(const location &location, const std::string &message);
 
+		bool read_file(const std::filesystem::path &path, std::string &data);
+
 		void push(std::string input, const std::string &name = std::string());
 
 		bool peek(tokenid token) const;
@@ -151,5 +178,6 @@ namespace reshadefx
 		std::unordered_map<std::string, macro> _macros;
 		std::vector<std::filesystem::path> _include_paths;
 		std::unordered_map<std::string, std::string> _file_cache;
+		include_cache *_include_cache = nullptr;
 	};
 }
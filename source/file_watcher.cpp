@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#include "dll_log.hpp"
+#include "file_watcher.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <Windows.h>
+
+struct reshade::file_watcher::directory
+{
+	~directory()
+	{
+		if (handle != INVALID_HANDLE_VALUE)
+		{
+			// Cancel the pending read and wait for it to complete before the buffer is freed
+			DWORD size = 0;
+			CancelIoEx(handle, &overlapped);
+			GetOverlappedResult(handle, &overlapped, &size, TRUE);
+			CloseHandle(handle);
+		}
+		if (overlapped.hEvent != nullptr)
+			CloseHandle(overlapped.hEvent);
+	}
+
+	bool read_changes()
+	{
+		ResetEvent(overlapped.hEvent);
+		return ReadDirectoryChangesW(handle, buffer, sizeof(buffer), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, nullptr, &overlapped, nullptr) != FALSE;
+	}
+
+	void scan(std::vector<std::filesystem::path> *modifications)
+	{
+		std::error_code ec;
+		for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(path, std::filesystem::directory_options::skip_permission_denied, ec))
+		{
+			if (entry.is_directory(ec))
+				continue;
+
+			const std::filesystem::file_time_type modified = entry.last_write_time(ec);
+			if (std::filesystem::file_time_type &timestamp = timestamps[entry.path().native()];
+				timestamp != modified)
+			{
+				if (modifications != nullptr)
+					modifications->push_back(entry.path());
+				timestamp = modified;
+			}
+		}
+	}
+
+	void fall_back_to_polling()
+	{
+		if (handle != INVALID_HANDLE_VALUE)
+		{
+			CancelIoEx(handle, &overlapped);
+			CloseHandle(handle);
+			handle = INVALID_HANDLE_VALUE;
+		}
+
+		LOG(WARN) << "Unable to receive change notifications for " << path << ". Falling back to polling.";
+
+		// Take a snapshot of the current state to compare against later
+		scan(nullptr);
+	}
+
+	std::filesystem::path path;
+	HANDLE handle = INVALID_HANDLE_VALUE;
+	OVERLAPPED overlapped = {};
+	// Has to be DWORD aligned for the 'FILE_NOTIFY_INFORMATION' entries written into it
+	alignas(DWORD) BYTE buffer[16384];
+	// Last modification time of every file, used only when polling
+	std::unordered_map<std::wstring, std::filesystem::file_time_type> timestamps;
+};
+
+reshade::file_watcher::file_watcher(const std::vector<std::filesystem::path> &paths)
+{
+	for (const std::filesystem::path &path : paths)
+	{
+		std::error_code ec;
+		std::filesystem::path canonical_path = std::filesystem::canonical(path, ec);
+		if (ec || !std::filesystem::is_directory(canonical_path, ec))
+			continue;
+		if (std::find_if(_directories.begin(), _directories.end(),
+			[&canonical_path](const std::unique_ptr<directory> &dir) { return dir->path == canonical_path; }) != _directories.end())
+			continue;
+
+		directory &dir = *_directories.emplace_back(std::make_unique<directory>());
+		dir.path = std::move(canonical_path);
+		dir.handle = CreateFileW(dir.path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		dir.overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+		if (dir.handle == INVALID_HANDLE_VALUE || dir.overlapped.hEvent == nullptr || !dir.read_changes())
+			dir.fall_back_to_polling();
+	}
+}
+reshade::file_watcher::~file_watcher()
+{
+}
+
+bool reshade::file_watcher::check(std::vector<std::filesystem::path> &modifications)
+{
+	const auto now = std::chrono::steady_clock::now();
+	const size_t num_pending_modifications = _pending_modifications.size();
+
+	// Polling is comparatively expensive, so only do it every now and then
+	const bool poll = now - _last_poll_time > std::chrono::seconds(1);
+	if (poll)
+		_last_poll_time = now;
+
+	for (const std::unique_ptr<directory> &dir : _directories)
+	{
+		if (dir->handle == INVALID_HANDLE_VALUE)
+		{
+			if (poll)
+				dir->scan(&_pending_modifications);
+			continue;
+		}
+
+		DWORD size = 0;
+		if (!GetOverlappedResult(dir->handle, &dir->overlapped, &size, FALSE))
+		{
+			if (GetLastError() != ERROR_IO_INCOMPLETE)
+				dir->fall_back_to_polling();
+			continue; // No changes yet
+		}
+
+		if (size == 0)
+		{
+			// The buffer overflowed and the individual changes were lost, so consider every file in the directory modified
+			std::error_code ec;
+			for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(dir->path, std::filesystem::directory_options::skip_permission_denied, ec))
+				if (!entry.is_directory(ec))
+					_pending_modifications.push_back(entry.path());
+		}
+		else
+		{
+			for (const BYTE *data = dir->buffer;;)
+			{
+				const auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(data);
+
+				// Ignore removed files, those cannot be reloaded anyway
+				if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+					_pending_modifications.push_back(dir->path / std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+
+				if (info->NextEntryOffset == 0)
+					break;
+				data += info->NextEntryOffset;
+			}
+		}
+
+		// Queue the next read right away, so that no changes are missed
+		if (!dir->read_changes())
+			dir->fall_back_to_polling();
+	}
+
+	if (_pending_modifications.size() != num_pending_modifications)
+		_last_change_time = now;
+
+	// Wait until things settled down, since editors tend to write files in multiple steps
+	if (_pending_modifications.empty() || now - _last_change_time < std::chrono::milliseconds(250))
+		return false;
+
+	std::sort(_pending_modifications.begin(), _pending_modifications.end());
+	_pending_modifications.erase(std::unique(_pending_modifications.begin(), _pending_modifications.end()), _pending_modifications.end());
+
+	modifications.insert(modifications.end(), _pending_modifications.begin(), _pending_modifications.end());
+	_pending_modifications.clear();
+
+	return true;
+}
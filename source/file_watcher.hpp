@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <filesystem>
+
+namespace reshade
+{
+	/// <summary>
+	/// Watches a set of directories for files that are added or modified.
+	/// Uses directory change notifications where possible and falls back to polling file timestamps for directories that do not support them.
+	/// </summary>
+	class file_watcher
+	{
+	public:
+		/// <summary>
+		/// Starts watching the specified <paramref name="paths"/>. Paths that do not exist or are listed multiple times are ignored.
+		/// </summary>
+		/// <param name="paths">The list of directories to watch (not recursively).</param>
+		explicit file_watcher(const std::vector<std::filesystem::path> &paths);
+		~file_watcher();
+
+		file_watcher(const file_watcher &) = delete;
+		file_watcher &operator=(const file_watcher &) = delete;
+
+		/// <summary>
+		/// Checks for modifications without blocking.
+		/// Modifications are only reported after no further changes happened for a short while, so that a file saved in multiple steps is reported just once.
+		/// </summary>
+		/// <param name="modifications">A list that is filled with the absolute paths of all files that were added or modified since the last report.</param>
+		/// <returns><c>true</c> if there were any modifications, <c>false</c> otherwise.</returns>
+		bool check(std::vector<std::filesystem::path> &modifications);
+
+	private:
+		struct directory;
+
+		std::vector<std::unique_ptr<directory>> _directories;
+		std::vector<std::filesystem::path> _pending_modifications;
+		std::chrono::steady_clock::time_point _last_change_time;
+		std::chrono::steady_clock::time_point _last_poll_time;
+	};
+}
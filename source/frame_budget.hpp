@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace reshade
+{
+	/// <summary>
+	/// Adjusts the render scale of techniques so that the combined GPU time of all techniques stays within a budget.
+	/// </summary>
+	class frame_budget_controller
+	{
+	public:
+		/// <summary>
+		/// Lowest render scale a technique is reduced to.
+		/// </summary>
+		static constexpr float MIN_SCALE = 0.5f;
+		/// <summary>
+		/// Amount the render scale of a technique is changed by in a single adjustment.
+		/// </summary>
+		static constexpr float SCALE_STEP = 0.125f;
+		/// <summary>
+		/// Fraction of the budget the estimated cost after increasing a render scale has to stay below.
+		/// The gap between this and the full budget keeps the controller from switching back and forth between two scales.
+		/// </summary>
+		static constexpr float HEADROOM = 0.85f;
+		/// <summary>
+		/// Number of frames the budget has to be exceeded in a row before reducing a render scale, and the number of frames to wait after any adjustment for the timings to settle.
+		/// </summary>
+		static constexpr unsigned int SETTLE_FRAMES = 30;
+
+		/// <summary>
+		/// State of a single technique as seen by the controller.
+		/// </summary>
+		struct entry
+		{
+			/// <summary>
+			/// Whether the render scale of this technique may be changed.
+			/// </summary>
+			bool scalable = false;
+			/// <summary>
+			/// Current render scale, in the range <see cref="MIN_SCALE"/> to 1.
+			/// </summary>
+			float scale = 1.0f;
+			/// <summary>
+			/// Exponential moving average of the GPU time of this technique in nanoseconds.
+			/// </summary>
+			float average_duration = 0.0f;
+
+			/// <summary>
+			/// Adds a new GPU time measurement of this technique.
+			/// </summary>
+			void record(uint64_t duration)
+			{
+				average_duration = (average_duration == 0.0f) ? static_cast<float>(duration) : average_duration + (static_cast<float>(duration) - average_duration) * 0.1f;
+			}
+		};
+
+		/// <summary>
+		/// Evaluates the recorded timings of the specified techniques against the budget and changes the render scale of at most one of them.
+		/// Should be called once per frame after all measurements for that frame were recorded.
+		/// </summary>
+		/// <param name="entries">Pointers to the state of all techniques that are currently rendered.</param>
+		/// <param name="count">Number of entries in <paramref name="entries"/>.</param>
+		/// <param name="budget">GPU time budget in nanoseconds.</param>
+		/// <returns><see langword="true"/> if a render scale was changed, <see langword="false"/> otherwise.</returns>
+		bool update(entry *const *entries, size_t count, uint64_t budget)
+		{
+			if (_cooldown != 0)
+			{
+				_cooldown--;
+				return false;
+			}
+
+			float total_duration = 0.0f;
+			for (size_t i = 0; i < count; ++i)
+				total_duration += entries[i]->average_duration;
+
+			if (total_duration > static_cast<float>(budget))
+			{
+				if (++_frames_over_budget < SETTLE_FRAMES)
+					return false;
+
+				// Reduce the most expensive technique first, since that frees up the most time
+				entry *target = nullptr;
+				for (size_t i = 0; i < count; ++i)
+					if (entries[i]->scalable && entries[i]->scale > MIN_SCALE && (target == nullptr || entries[i]->average_duration > target->average_duration))
+						target = entries[i];
+				if (target == nullptr)
+					return false;
+
+				target->scale = (target->scale - SCALE_STEP < MIN_SCALE) ? MIN_SCALE : target->scale - SCALE_STEP;
+			}
+			else
+			{
+				_frames_over_budget = 0;
+
+				// Restore the technique that was reduced the most first
+				entry *target = nullptr;
+				for (size_t i = 0; i < count; ++i)
+					if (entries[i]->scalable && entries[i]->scale < 1.0f && (target == nullptr || entries[i]->scale < target->scale))
+						target = entries[i];
+				if (target == nullptr)
+					return false;
+
+				const float new_scale = (target->scale + SCALE_STEP > 1.0f) ? 1.0f : target->scale + SCALE_STEP;
+
+				// GPU time is roughly proportional to the number of pixels, so estimate what the total would be after the change and only go ahead if that still leaves some headroom
+				const float new_duration = target->average_duration * (new_scale * new_scale) / (target->scale * target->scale);
+				if (total_duration - target->average_duration + new_duration > static_cast<float>(budget) * HEADROOM)
+					return false;
+
+				target->scale = new_scale;
+			}
+
+			_cooldown = SETTLE_FRAMES;
+			_frames_over_budget = 0;
+			return true;
+		}
+
+	private:
+		unsigned int _cooldown = 0;
+		unsigned int _frames_over_budget = 0;
+	};
+}
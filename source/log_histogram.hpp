@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace reshade
+{
+	/// <summary>
+	/// A histogram of durations with logarithmically spaced buckets, which uses a fixed amount of memory no matter how many values are recorded.
+	/// Every power of two range is split into 16 buckets, so percentiles calculated from it are accurate to within about 6%.
+	/// </summary>
+	class log_histogram
+	{
+		static constexpr unsigned int SUB_BUCKET_BITS = 4;
+		static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+		static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+	public:
+		/// <summary>
+		/// Removes all recorded values.
+		/// </summary>
+		void clear()
+		{
+			for (size_t i = 0; i < BUCKET_COUNT; ++i)
+				_buckets[i] = 0;
+			_count = 0;
+		}
+
+		/// <summary>
+		/// Adds a value to the histogram.
+		/// </summary>
+		void record(uint64_t value)
+		{
+			_buckets[bucket_index(value)]++;
+			_count++;
+		}
+
+		/// <summary>
+		/// Gets the number of values that were recorded since the last <see cref="clear"/>.
+		/// </summary>
+		uint64_t count() const { return _count; }
+
+		/// <summary>
+		/// Gets the value below which the specified <paramref name="percentage"/> of recorded values fall.
+		/// </summary>
+		/// <param name="percentage">The percentile to get, in the range 0 to 100.</param>
+		/// <returns>The midpoint of the bucket containing the percentile, or zero if nothing was recorded yet.</returns>
+		uint64_t percentile(double percentage) const
+		{
+			if (_count == 0)
+				return 0;
+
+			uint64_t target = static_cast<uint64_t>(percentage * 0.01 * _count + 0.5);
+			if (target == 0)
+				target = 1;
+
+			uint64_t sum = 0;
+			for (size_t i = 0; i < BUCKET_COUNT; ++i)
+				if ((sum += _buckets[i]) >= target)
+					return bucket_value(i);
+
+			return bucket_value(BUCKET_COUNT - 1);
+		}
+
+	private:
+		static size_t bucket_index(uint64_t value)
+		{
+			// Small values are stored exactly
+			if (value < SUB_BUCKET_COUNT)
+				return static_cast<size_t>(value);
+
+			unsigned int exponent = SUB_BUCKET_BITS;
+			while (exponent < 63 && (value >> (exponent + 1)) != 0)
+				exponent++;
+
+			// Use the bits following the most significant one to pick the bucket in this power of two range
+			const size_t sub_bucket = static_cast<size_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+			return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + sub_bucket;
+		}
+		static uint64_t bucket_value(size_t index)
+		{
+			if (index < SUB_BUCKET_COUNT)
+				return index;
+
+			const unsigned int shift = static_cast<unsigned int>(index / SUB_BUCKET_COUNT) - 1;
+			const uint64_t lower_bound = static_cast<uint64_t>(SUB_BUCKET_COUNT + (index % SUB_BUCKET_COUNT)) << shift;
+			return lower_bound + ((uint64_t(1) << shift) >> 1);
+		}
+
+		uint64_t _count = 0;
+		uint32_t _buckets[BUCKET_COUNT] = {};
+	};
+}
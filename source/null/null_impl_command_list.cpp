@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#include "null_impl_device.hpp"
+#include "null_impl_command_list.hpp"
+#include "null_impl_objects.hpp"
+#include <chrono>
+
+reshade::null::command_list_impl::command_list_impl(device_impl *device) :
+	api_object_impl(nullptr), _device_impl(device)
+{
+#if RESHADE_ADDON
+	invoke_addon_event<addon_event::init_command_list>(this);
+#endif
+}
+reshade::null::command_list_impl::~command_list_impl()
+{
+#if RESHADE_ADDON
+	invoke_addon_event<addon_event::destroy_command_list>(this);
+#endif
+}
+
+reshade::api::device *reshade::null::command_list_impl::get_device()
+{
+	return _device_impl;
+}
+
+void reshade::null::command_list_impl::barrier(uint32_t, const api::resource *, const api::resource_usage *, const api::resource_usage *)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::begin_render_pass(api::render_pass, api::framebuffer)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::finish_render_pass()
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::bind_render_targets_and_depth_stencil(uint32_t, const api::resource_view *, api::resource_view)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::bind_pipeline(api::pipeline_stage, api::pipeline)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::bind_pipeline_states(uint32_t, const api::dynamic_state *, const uint32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::bind_viewports(uint32_t, uint32_t, const float *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::bind_scissor_rects(uint32_t, uint32_t, const int32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::push_constants(api::shader_stage, api::pipeline_layout, uint32_t, uint32_t, uint32_t, const void *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::push_descriptors(api::shader_stage, api::pipeline_layout, uint32_t, const api::descriptor_set_update &)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::bind_descriptor_sets(api::shader_stage, api::pipeline_layout, uint32_t, uint32_t, const api::descriptor_set *)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::bind_index_buffer(api::resource, uint64_t, uint32_t)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::bind_vertex_buffers(uint32_t, uint32_t, const api::resource *, const uint64_t *, const uint32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::draw(uint32_t, uint32_t, uint32_t, uint32_t)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::draw_indexed(uint32_t, uint32_t, uint32_t, int32_t, uint32_t)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::dispatch(uint32_t, uint32_t, uint32_t)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::draw_or_dispatch_indirect(api::indirect_command, api::resource, uint64_t, uint32_t, uint32_t)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::copy_resource(api::resource source, api::resource dest)
+{
+	_device_impl->count_call(__func__);
+
+	assert(source.handle != 0 && dest.handle != 0);
+	const auto source_impl = reinterpret_cast<resource_impl *>(source.handle);
+	const auto dest_impl = reinterpret_cast<resource_impl *>(dest.handle);
+
+	// Only copy memory that was already accessed on the host, everything else is undefined anyway
+	if (source_impl->data != nullptr && source_impl->size == dest_impl->size)
+		std::memcpy(dest_impl->get_data(), source_impl->data.get(), static_cast<size_t>(source_impl->size));
+}
+void reshade::null::command_list_impl::copy_buffer_region(api::resource source, uint64_t source_offset, api::resource dest, uint64_t dest_offset, uint64_t size)
+{
+	_device_impl->count_call(__func__);
+
+	assert(source.handle != 0 && dest.handle != 0);
+	const auto source_impl = reinterpret_cast<resource_impl *>(source.handle);
+	const auto dest_impl = reinterpret_cast<resource_impl *>(dest.handle);
+
+	if (source_offset + size <= source_impl->size && dest_offset + size <= dest_impl->size)
+		std::memmove(dest_impl->get_data() + dest_offset, source_impl->get_data() + source_offset, static_cast<size_t>(size));
+}
+void reshade::null::command_list_impl::copy_buffer_to_texture(api::resource, uint64_t, uint32_t, uint32_t, api::resource, uint32_t, const int32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::copy_texture_region(api::resource, uint32_t, const int32_t *, api::resource, uint32_t, const int32_t *, api::filter_mode)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::copy_texture_to_buffer(api::resource, uint32_t, const int32_t *, api::resource, uint64_t, uint32_t, uint32_t)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::resolve_texture_region(api::resource, uint32_t, const int32_t *, api::resource, uint32_t, const int32_t *, api::format)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::clear_attachments(api::attachment_type, const float *, float, uint8_t, uint32_t, const int32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::clear_depth_stencil_view(api::resource_view, api::attachment_type, float, uint8_t, uint32_t, const int32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::clear_render_target_view(api::resource_view, const float *, uint32_t, const int32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::clear_unordered_access_view_uint(api::resource_view, const uint32_t *, uint32_t, const int32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::clear_unordered_access_view_float(api::resource_view, const float *, uint32_t, const int32_t *)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::generate_mipmaps(api::resource_view)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::begin_query(api::query_pool, api::query_type, uint32_t)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::finish_query(api::query_pool pool, api::query_type type, uint32_t index)
+{
+	_device_impl->count_call(__func__);
+
+	assert(pool.handle != 0);
+	const auto impl = reinterpret_cast<query_pool_impl *>(pool.handle);
+
+	if (type == api::query_type::timestamp && index < impl->results.size())
+	{
+		// Timestamps are taken on the CPU, so that time measurements in the runtime still produce sensible values, unless a fixed step between them was requested
+		if (const uint64_t step = _device_impl->_timestamp_step; step != 0)
+			impl->results[index] = _device_impl->_last_timestamp += step;
+		else
+			impl->results[index] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+	}
+}
+void reshade::null::command_list_impl::copy_query_pool_results(api::query_pool, api::query_type, uint32_t, uint32_t, api::resource, uint64_t, uint32_t)
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_list_impl::begin_debug_event(const char *, const float *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::finish_debug_event()
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_list_impl::insert_debug_marker(const char *, const float *)
+{
+	_device_impl->count_call(__func__);
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#include "null_impl_device.hpp"
+#include "null_impl_command_queue.hpp"
+
+reshade::null::command_queue_impl::command_queue_impl(device_impl *device) :
+	api_object_impl(nullptr), _device_impl(device), _immediate_cmd_list(device)
+{
+#if RESHADE_ADDON
+	invoke_addon_event<addon_event::init_command_queue>(this);
+#endif
+}
+reshade::null::command_queue_impl::~command_queue_impl()
+{
+#if RESHADE_ADDON
+	invoke_addon_event<addon_event::destroy_command_queue>(this);
+#endif
+}
+
+reshade::api::device *reshade::null::command_queue_impl::get_device()
+{
+	return _device_impl;
+}
+
+void reshade::null::command_queue_impl::flush_immediate_command_list() const
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_queue_impl::wait_idle() const
+{
+	_device_impl->count_call(__func__);
+}
+
+void reshade::null::command_queue_impl::begin_debug_event(const char *, const float *)
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_queue_impl::finish_debug_event()
+{
+	_device_impl->count_call(__func__);
+}
+void reshade::null::command_queue_impl::insert_debug_marker(const char *, const float *)
+{
+	_device_impl->count_call(__func__);
+}
@@ -0,0 +1,490 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#include "null_impl_device.hpp"
+#include "null_impl_objects.hpp"
+#include <map>
+#include <algorithm>
+
+reshade::null::device_impl::device_impl() :
+	api_object_impl(nullptr)
+{
+#if RESHADE_ADDON
+	load_addons();
+
+	invoke_addon_event<addon_event::init_device>(this);
+#endif
+}
+reshade::null::device_impl::~device_impl()
+{
+#if RESHADE_ADDON
+	invoke_addon_event<addon_event::destroy_device>(this);
+
+	unload_addons();
+#endif
+
+	assert(_num_live_objects == 0);
+}
+
+bool reshade::null::device_impl::check_capability(api::device_caps capability) const
+{
+	count_call(__func__);
+
+	switch (capability)
+	{
+	case api::device_caps::partial_push_constant_updates:
+	case api::device_caps::copy_buffer_to_texture:
+	case api::device_caps::blit:
+	case api::device_caps::resolve_region:
+	case api::device_caps::copy_query_pool_results:
+	case api::device_caps::sampler_with_resource_view:
+		// Same answers as a D3D11 device, so that the runtime behaves the same way
+		return false;
+	default:
+		return true;
+	}
+}
+bool reshade::null::device_impl::check_format_support(api::format format, api::resource_usage) const
+{
+	count_call(__func__);
+
+	return format != api::format::unknown;
+}
+
+bool reshade::null::device_impl::create_sampler(const api::sampler_desc &, api::sampler *out_handle)
+{
+	count_call(__func__);
+	count_allocation();
+
+	*out_handle = { _next_handle++ };
+	return true;
+}
+void reshade::null::device_impl::destroy_sampler(api::sampler handle)
+{
+	count_call(__func__);
+
+	if (handle.handle != 0)
+		count_deallocation();
+}
+
+bool reshade::null::device_impl::create_resource(const api::resource_desc &desc, const api::subresource_data *initial_data, api::resource_usage, api::resource *out_handle)
+{
+	count_call(__func__);
+
+	const auto impl = new resource_impl(desc);
+	count_allocation(impl->size);
+
+	if (initial_data != nullptr)
+	{
+		if (desc.type == api::resource_type::buffer)
+		{
+			std::memcpy(impl->get_data(), initial_data->data, static_cast<size_t>(impl->size));
+		}
+		else
+		{
+			for (uint32_t subresource = 0; subresource < impl->subresources.size(); ++subresource)
+				impl->copy_from(initial_data[subresource], subresource, nullptr);
+		}
+	}
+
+	*out_handle = { reinterpret_cast<uintptr_t>(impl) };
+	return true;
+}
+void reshade::null::device_impl::destroy_resource(api::resource handle)
+{
+	count_call(__func__);
+
+	if (handle.handle == 0)
+		return;
+
+	delete reinterpret_cast<resource_impl *>(handle.handle);
+	count_deallocation();
+}
+
+bool reshade::null::device_impl::create_resource_view(api::resource resource, api::resource_usage, const api::resource_view_desc &desc, api::resource_view *out_handle)
+{
+	count_call(__func__);
+
+	if (resource.handle == 0)
+	{
+		*out_handle = { 0 };
+		return false;
+	}
+
+	const auto impl = new resource_view_impl { resource, desc };
+	count_allocation();
+
+	*out_handle = { reinterpret_cast<uintptr_t>(impl) };
+	return true;
+}
+void reshade::null::device_impl::destroy_resource_view(api::resource_view handle)
+{
+	count_call(__func__);
+
+	if (handle.handle == 0)
+		return;
+
+	delete reinterpret_cast<resource_view_impl *>(handle.handle);
+	count_deallocation();
+}
+
+bool reshade::null::device_impl::create_pipeline(const api::pipeline_desc &, api::pipeline *out_handle)
+{
+	count_call(__func__);
+	count_allocation();
+
+	*out_handle = { _next_handle++ };
+	return true;
+}
+void reshade::null::device_impl::destroy_pipeline(api::pipeline_stage, api::pipeline handle)
+{
+	count_call(__func__);
+
+	if (handle.handle != 0)
+		count_deallocation();
+}
+
+bool reshade::null::device_impl::create_render_pass(const api::render_pass_desc &, api::render_pass *out_handle)
+{
+	count_call(__func__);
+	count_allocation();
+
+	*out_handle = { _next_handle++ };
+	return true;
+}
+void reshade::null::device_impl::destroy_render_pass(api::render_pass handle)
+{
+	count_call(__func__);
+
+	if (handle.handle != 0)
+		count_deallocation();
+}
+
+bool reshade::null::device_impl::create_framebuffer(const api::framebuffer_desc &desc, api::framebuffer *out_handle)
+{
+	count_call(__func__);
+
+	const auto impl = new framebuffer_impl { desc };
+	count_allocation();
+
+	*out_handle = { reinterpret_cast<uintptr_t>(impl) };
+	return true;
+}
+void reshade::null::device_impl::destroy_framebuffer(api::framebuffer handle)
+{
+	count_call(__func__);
+
+	if (handle.handle == 0)
+		return;
+
+	delete reinterpret_cast<framebuffer_impl *>(handle.handle);
+	count_deallocation();
+}
+
+bool reshade::null::device_impl::create_pipeline_layout(uint32_t param_count, const api::pipeline_layout_param *params, api::pipeline_layout *out_handle)
+{
+	count_call(__func__);
+
+	const auto impl = new pipeline_layout_impl();
+	impl->params.assign(params, params + param_count);
+	count_allocation();
+
+	*out_handle = { reinterpret_cast<uintptr_t>(impl) };
+	return true;
+}
+void reshade::null::device_impl::destroy_pipeline_layout(api::pipeline_layout handle)
+{
+	count_call(__func__);
+
+	if (handle.handle == 0)
+		return;
+
+	delete reinterpret_cast<pipeline_layout_impl *>(handle.handle);
+	count_deallocation();
+}
+
+bool reshade::null::device_impl::create_descriptor_set_layout(uint32_t range_count, const api::descriptor_range *ranges, bool, api::descriptor_set_layout *out_handle)
+{
+	count_call(__func__);
+
+	const auto impl = new descriptor_set_layout_impl();
+	impl->ranges.assign(ranges, ranges + range_count);
+	count_allocation();
+
+	*out_handle = { reinterpret_cast<uintptr_t>(impl) };
+	return true;
+}
+void reshade::null::device_impl::destroy_descriptor_set_layout(api::descriptor_set_layout handle)
+{
+	count_call(__func__);
+
+	if (handle.handle == 0)
+		return;
+
+	delete reinterpret_cast<descriptor_set_layout_impl *>(handle.handle);
+	count_deallocation();
+}
+
+bool reshade::null::device_impl::create_query_pool(api::query_type, uint32_t size, api::query_pool *out_handle)
+{
+	count_call(__func__);
+
+	const auto impl = new query_pool_impl();
+	impl->results.resize(size);
+	count_allocation(size * sizeof(uint64_t));
+
+	*out_handle = { reinterpret_cast<uintptr_t>(impl) };
+	return true;
+}
+void reshade::null::device_impl::destroy_query_pool(api::query_pool handle)
+{
+	count_call(__func__);
+
+	if (handle.handle == 0)
+		return;
+
+	delete reinterpret_cast<query_pool_impl *>(handle.handle);
+	count_deallocation();
+}
+
+bool reshade::null::device_impl::create_descriptor_sets(uint32_t count, const api::descriptor_set_layout *, api::descriptor_set *out_sets)
+{
+	count_call(__func__);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		count_allocation();
+		out_sets[i] = { _next_handle++ };
+	}
+	return true;
+}
+void reshade::null::device_impl::destroy_descriptor_sets(uint32_t count, const api::descriptor_set *sets)
+{
+	count_call(__func__);
+
+	for (uint32_t i = 0; i < count; ++i)
+		if (sets[i].handle != 0)
+			count_deallocation();
+}
+
+bool reshade::null::device_impl::map_buffer_region(api::resource resource, uint64_t offset, uint64_t, api::map_access, void **out_data)
+{
+	count_call(__func__);
+
+	assert(resource.handle != 0);
+	const auto impl = reinterpret_cast<resource_impl *>(resource.handle);
+
+	if (impl->desc.type != api::resource_type::buffer || offset >= impl->size)
+	{
+		*out_data = nullptr;
+		return false;
+	}
+
+	*out_data = impl->get_data() + offset;
+	return true;
+}
+void reshade::null::device_impl::unmap_buffer_region(api::resource)
+{
+	count_call(__func__);
+}
+bool reshade::null::device_impl::map_texture_region(api::resource resource, uint32_t subresource, const int32_t box[6], api::map_access, api::subresource_data *out_data)
+{
+	count_call(__func__);
+
+	assert(resource.handle != 0);
+	const auto impl = reinterpret_cast<resource_impl *>(resource.handle);
+
+	if (impl->desc.type == api::resource_type::buffer || subresource >= impl->subresources.size() || box != nullptr)
+	{
+		*out_data = {};
+		return false;
+	}
+
+	const resource_impl::subresource_layout &layout = impl->subresources[subresource];
+	out_data->data = impl->get_data() + layout.offset;
+	out_data->row_pitch = layout.row_pitch;
+	out_data->slice_pitch = layout.slice_pitch;
+	return true;
+}
+void reshade::null::device_impl::unmap_texture_region(api::resource, uint32_t)
+{
+	count_call(__func__);
+}
+
+void reshade::null::device_impl::update_buffer_region(const void *data, api::resource resource, uint64_t offset, uint64_t size)
+{
+	count_call(__func__);
+
+	assert(resource.handle != 0);
+	const auto impl = reinterpret_cast<resource_impl *>(resource.handle);
+
+	if (impl->desc.type == api::resource_type::buffer && offset <= impl->size && size <= impl->size - offset)
+		std::memcpy(impl->get_data() + offset, data, static_cast<size_t>(size));
+}
+void reshade::null::device_impl::update_texture_region(const api::subresource_data &data, api::resource resource, uint32_t subresource, const int32_t box[6])
+{
+	count_call(__func__);
+
+	assert(resource.handle != 0);
+	const auto impl = reinterpret_cast<resource_impl *>(resource.handle);
+
+	if (impl->desc.type != api::resource_type::buffer && subresource < impl->subresources.size())
+		impl->copy_from(data, subresource, box);
+}
+
+void reshade::null::device_impl::update_descriptor_sets(uint32_t, const api::descriptor_set_update *)
+{
+	count_call(__func__);
+}
+
+bool reshade::null::device_impl::get_query_pool_results(api::query_pool pool, uint32_t first, uint32_t count, void *results, uint32_t stride)
+{
+	count_call(__func__);
+
+	assert(pool.handle != 0);
+	assert(stride >= sizeof(uint64_t));
+	const auto impl = reinterpret_cast<const query_pool_impl *>(pool.handle);
+
+	if (first + count > impl->results.size())
+		return false;
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		// Queries that were never finished are not available yet, like on a real device
+		if (impl->results[first + i] == 0)
+			return false;
+
+		*reinterpret_cast<uint64_t *>(reinterpret_cast<uint8_t *>(results) + i * stride) = impl->results[first + i];
+	}
+	return true;
+}
+
+void reshade::null::device_impl::wait_idle() const
+{
+	count_call(__func__);
+}
+
+void reshade::null::device_impl::set_resource_name(api::resource, const char *)
+{
+	count_call(__func__);
+}
+
+void reshade::null::device_impl::get_pipeline_layout_desc(api::pipeline_layout layout, uint32_t *count, api::pipeline_layout_param *params) const
+{
+	count_call(__func__);
+
+	assert(layout.handle != 0 && count != nullptr);
+	const auto impl = reinterpret_cast<const pipeline_layout_impl *>(layout.handle);
+
+	if (params != nullptr)
+	{
+		*count = std::min(*count, static_cast<uint32_t>(impl->params.size()));
+		std::memcpy(params, impl->params.data(), *count * sizeof(api::pipeline_layout_param));
+	}
+	else
+	{
+		*count = static_cast<uint32_t>(impl->params.size());
+	}
+}
+
+void reshade::null::device_impl::get_descriptor_pool_offset(api::descriptor_set, api::descriptor_pool *pool, uint32_t *offset) const
+{
+	count_call(__func__);
+
+	// Descriptor sets are not allocated from pools
+	*pool = { 0 };
+	*offset = 0;
+}
+
+void reshade::null::device_impl::get_descriptor_set_layout_desc(api::descriptor_set_layout layout, uint32_t *count, api::descriptor_range *ranges) const
+{
+	count_call(__func__);
+
+	assert(layout.handle != 0 && count != nullptr);
+	const auto impl = reinterpret_cast<const descriptor_set_layout_impl *>(layout.handle);
+
+	if (ranges != nullptr)
+	{
+		*count = std::min(*count, static_cast<uint32_t>(impl->ranges.size()));
+		std::memcpy(ranges, impl->ranges.data(), *count * sizeof(api::descriptor_range));
+	}
+	else
+	{
+		*count = static_cast<uint32_t>(impl->ranges.size());
+	}
+}
+
+reshade::api::resource_desc reshade::null::device_impl::get_resource_desc(api::resource resource) const
+{
+	count_call(__func__);
+
+	assert(resource.handle != 0);
+
+	return reinterpret_cast<const resource_impl *>(resource.handle)->desc;
+}
+
+reshade::api::resource reshade::null::device_impl::get_resource_from_view(api::resource_view view) const
+{
+	count_call(__func__);
+
+	assert(view.handle != 0);
+
+	return reinterpret_cast<const resource_view_impl *>(view.handle)->resource;
+}
+
+reshade::api::resource_view reshade::null::device_impl::get_framebuffer_attachment(api::framebuffer framebuffer, api::attachment_type type, uint32_t index) const
+{
+	count_call(__func__);
+
+	assert(framebuffer.handle != 0);
+	const auto impl = reinterpret_cast<const framebuffer_impl *>(framebuffer.handle);
+
+	if (type == api::attachment_type::color)
+		return index < 8 ? impl->desc.render_targets[index] : api::resource_view { 0 };
+	else
+		return impl->desc.depth_stencil;
+}
+
+std::vector<std::pair<std::string, uint64_t>> reshade::null::device_impl::get_call_counts() const
+{
+	// Command lists and queues share some method names, so merge those here
+	std::map<std::string, uint64_t> merged;
+	{
+		const std::unique_lock<std::mutex> lock(_call_counts_mutex);
+		for (const auto &[name, count] : _call_counts)
+			merged[name] += count;
+	}
+
+	return { merged.begin(), merged.end() };
+}
+
+void reshade::null::device_impl::reset_statistics()
+{
+	{
+		const std::unique_lock<std::mutex> lock(_call_counts_mutex);
+		_call_counts.clear();
+	}
+
+	_num_allocations = 0;
+	_allocation_size = 0;
+}
+
+void reshade::null::device_impl::count_call(const char *name) const
+{
+	// Names are the '__func__' of the calling method, which are unique static strings, so can compare by pointer
+	const std::unique_lock<std::mutex> lock(_call_counts_mutex);
+	_call_counts[name]++;
+}
+void reshade::null::device_impl::count_allocation(uint64_t size)
+{
+	_num_allocations++;
+	_allocation_size += size;
+	_num_live_objects++;
+}
+void reshade::null::device_impl::count_deallocation()
+{
+	assert(_num_live_objects != 0);
+	_num_live_objects--;
+}
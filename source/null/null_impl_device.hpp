@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#pragma once
+
+#include "addon_manager.hpp"
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+namespace reshade::null
+{
+	/// <summary>
+	/// A render device that keeps all resources in host memory and does not execute any commands.
+	/// This is used to measure the CPU overhead of the runtime independent of any driver, and counts all calls made to it.
+	/// </summary>
+	class device_impl : public api::api_object_impl<void *, api::device>
+	{
+		friend class command_list_impl;
+		friend class command_queue_impl;
+
+	public:
+		device_impl();
+		~device_impl();
+
+		// Pretend to be D3D11, so that the runtime takes the HLSL code path and compiles shaders like it would with a real device
+		api::device_api get_api() const final { return api::device_api::d3d11; }
+
+		bool check_capability(api::device_caps capability) const final;
+		bool check_format_support(api::format format, api::resource_usage usage) const final;
+
+		bool create_sampler(const api::sampler_desc &desc, api::sampler *out_handle) final;
+		void destroy_sampler(api::sampler handle) final;
+
+		bool create_resource(const api::resource_desc &desc, const api::subresource_data *initial_data, api::resource_usage initial_state, api::resource *out_handle) final;
+		void destroy_resource(api::resource handle) final;
+
+		bool create_resource_view(api::resource resource, api::resource_usage usage_type, const api::resource_view_desc &desc, api::resource_view *out_handle) final;
+		void destroy_resource_view(api::resource_view handle) final;
+
+		bool create_pipeline(const api::pipeline_desc &desc, api::pipeline *out_handle) final;
+		void destroy_pipeline(api::pipeline_stage type, api::pipeline handle) final;
+
+		bool create_render_pass(const api::render_pass_desc &desc, api::render_pass *out_handle) final;
+		void destroy_render_pass(api::render_pass handle) final;
+
+		bool create_framebuffer(const api::framebuffer_desc &desc, api::framebuffer *out_handle) final;
+		void destroy_framebuffer(api::framebuffer handle) final;
+
+		bool create_pipeline_layout(uint32_t param_count, const api::pipeline_layout_param *params, api::pipeline_layout *out_handle) final;
+		void destroy_pipeline_layout(api::pipeline_layout handle) final;
+
+		bool create_descriptor_set_layout(uint32_t range_count, const api::descriptor_range *ranges, bool push_descriptors, api::descriptor_set_layout *out_handle) final;
+		void destroy_descriptor_set_layout(api::descriptor_set_layout handle) final;
+
+		bool create_query_pool(api::query_type type, uint32_t size, api::query_pool *out_handle) final;
+		void destroy_query_pool(api::query_pool handle) final;
+
+		bool create_descriptor_sets(uint32_t count, const api::descriptor_set_layout *layouts, api::descriptor_set *out_sets) final;
+		void destroy_descriptor_sets(uint32_t count, const api::descriptor_set *sets) final;
+
+		bool map_buffer_region(api::resource resource, uint64_t offset, uint64_t size, api::map_access access, void **out_data) final;
+		void unmap_buffer_region(api::resource resource) final;
+		bool map_texture_region(api::resource resource, uint32_t subresource, const int32_t box[6], api::map_access access, api::subresource_data *out_data) final;
+		void unmap_texture_region(api::resource resource, uint32_t subresource) final;
+
+		void update_buffer_region(const void *data, api::resource resource, uint64_t offset, uint64_t size) final;
+		void update_texture_region(const api::subresource_data &data, api::resource resource, uint32_t subresource, const int32_t box[6]) final;
+
+		void update_descriptor_sets(uint32_t count, const api::descriptor_set_update *updates) final;
+
+		bool get_query_pool_results(api::query_pool pool, uint32_t first, uint32_t count, void *results, uint32_t stride) final;
+
+		void wait_idle() const final;
+
+		void set_resource_name(api::resource resource, const char *name) final;
+
+		void get_pipeline_layout_desc(api::pipeline_layout layout, uint32_t *out_count, api::pipeline_layout_param *out_params) const final;
+
+		void get_descriptor_pool_offset(api::descriptor_set set, api::descriptor_pool *out_pool, uint32_t *out_offset) const final;
+
+		void get_descriptor_set_layout_desc(api::descriptor_set_layout layout, uint32_t *out_count, api::descriptor_range *out_ranges) const final;
+
+		api::resource_desc get_resource_desc(api::resource resource) const final;
+
+		api::resource get_resource_from_view(api::resource_view view) const final;
+
+		api::resource_view get_framebuffer_attachment(api::framebuffer framebuffer, api::attachment_type type, uint32_t index) const final;
+
+		/// <summary>
+		/// Gets the number of calls made to each method of the device, its command lists and queues since the last <see cref="reset_statistics"/>, sorted by name.
+		/// </summary>
+		std::vector<std::pair<std::string, uint64_t>> get_call_counts() const;
+		/// <summary>
+		/// Gets the number of objects that were created since the last <see cref="reset_statistics"/>.
+		/// </summary>
+		uint64_t get_allocation_count() const { return _num_allocations; }
+		/// <summary>
+		/// Gets the number of bytes of host memory that were allocated for resources since the last <see cref="reset_statistics"/>.
+		/// </summary>
+		uint64_t get_allocation_size() const { return _allocation_size; }
+		/// <summary>
+		/// Gets the number of objects that currently exist.
+		/// </summary>
+		uint64_t get_live_object_count() const { return _num_live_objects; }
+
+		void reset_statistics();
+
+		/// <summary>
+		/// Makes timestamp queries return a counter that advances by <paramref name="step"/> nanoseconds with every query instead of the CPU clock, so that GPU timings are deterministic.
+		/// Setting it to zero reverts to the CPU clock.
+		/// </summary>
+		void set_timestamp_step(uint64_t step) { _timestamp_step = step; _last_timestamp = 0; }
+
+	private:
+		void count_call(const char *name) const;
+		void count_allocation(uint64_t size = 0);
+		void count_deallocation();
+
+		mutable std::mutex _call_counts_mutex;
+		mutable std::unordered_map<const char *, uint64_t> _call_counts;
+		std::atomic<uint64_t> _num_allocations = 0;
+		std::atomic<uint64_t> _allocation_size = 0;
+		std::atomic<uint64_t> _num_live_objects = 0;
+		std::atomic<uint64_t> _timestamp_step = 0;
+		std::atomic<uint64_t> _last_timestamp = 0;
+		// Objects that have no state are identified by a unique number instead of a pointer
+		std::atomic<uint64_t> _next_handle = 1;
+	};
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+
+namespace reshade::null
+{
+	struct resource_impl
+	{
+		struct subresource_layout
+		{
+			uint64_t offset;
+			uint32_t row_pitch;
+			uint32_t slice_pitch;
+			uint32_t width;
+			uint32_t height;
+			uint32_t depth;
+		};
+
+		explicit resource_impl(const api::resource_desc &desc) : desc(desc)
+		{
+			if (desc.type == api::resource_type::buffer)
+			{
+				size = desc.buffer.size;
+				return;
+			}
+
+			const uint32_t levels = desc.texture.levels != 0 ? desc.texture.levels : 1;
+			const uint32_t layers = desc.type == api::resource_type::texture_3d ? 1 : desc.texture.depth_or_layers;
+
+			for (uint32_t layer = 0; layer < layers; ++layer)
+			{
+				for (uint32_t level = 0; level < levels; ++level)
+				{
+					subresource_layout &layout = subresources.emplace_back();
+					layout.offset = size;
+					layout.width = std::max(1u, desc.texture.width >> level);
+					layout.height = std::max(1u, desc.texture.height >> level);
+					layout.depth = desc.type == api::resource_type::texture_3d ? std::max(1u, static_cast<uint32_t>(desc.texture.depth_or_layers) >> level) : 1;
+					layout.row_pitch = api::format_row_pitch(desc.texture.format, layout.width);
+					layout.slice_pitch = api::format_slice_pitch(desc.texture.format, layout.row_pitch, layout.height);
+
+					size += static_cast<uint64_t>(layout.slice_pitch) * layout.depth;
+				}
+			}
+		}
+
+		// Memory is only allocated once it is actually accessed, since most resources are only ever used on the (non-existent) GPU
+		uint8_t *get_data()
+		{
+			if (data == nullptr)
+				data.reset(new uint8_t[static_cast<size_t>(size)]());
+			return data.get();
+		}
+
+		void copy_from(const api::subresource_data &source, uint32_t subresource, const int32_t box[6])
+		{
+			if (source.data == nullptr)
+				return;
+
+			const subresource_layout &layout = subresources[subresource];
+
+			uint32_t left = 0, top = 0, front = 0;
+			uint32_t right = layout.width, bottom = layout.height, back = layout.depth;
+			if (box != nullptr)
+			{
+				// Clamp the box to the subresource, so that an invalid box cannot write outside of it
+				left   = std::min(static_cast<uint32_t>(std::max(box[0], 0)), layout.width);
+				top    = std::min(static_cast<uint32_t>(std::max(box[1], 0)), layout.height);
+				front  = std::min(static_cast<uint32_t>(std::max(box[2], 0)), layout.depth);
+				right  = std::clamp(static_cast<uint32_t>(std::max(box[3], 0)), left, layout.width);
+				bottom = std::clamp(static_cast<uint32_t>(std::max(box[4], 0)), top, layout.height);
+				back   = std::clamp(static_cast<uint32_t>(std::max(box[5], 0)), front, layout.depth);
+			}
+
+			// Block compressed formats have one row per four texel rows, and one block per four texel columns
+			const uint32_t block_size = api::format_slice_pitch(desc.texture.format, 1, 4) == 1 ? 4 : 1;
+			left -= left % block_size;
+			top -= top % block_size;
+
+			const uint32_t rows = (bottom + block_size - 1) / block_size - top / block_size;
+			const uint32_t slices = back - front;
+			const uint32_t row_offset = api::format_row_pitch(desc.texture.format, left);
+			const uint32_t row_size = std::min(api::format_row_pitch(desc.texture.format, right - left), layout.row_pitch - row_offset);
+			const uint64_t dest_offset = layout.offset + static_cast<uint64_t>(front) * layout.slice_pitch + static_cast<uint64_t>(top / block_size) * layout.row_pitch + row_offset;
+
+			uint8_t *const dest = get_data() + dest_offset;
+			for (uint32_t z = 0; z < slices; ++z)
+				for (uint32_t y = 0; y < rows; ++y)
+					std::memcpy(
+						dest + static_cast<size_t>(z) * layout.slice_pitch + static_cast<size_t>(y) * layout.row_pitch,
+						static_cast<const uint8_t *>(source.data) + static_cast<size_t>(z) * source.slice_pitch + static_cast<size_t>(y) * source.row_pitch,
+						std::min(row_size, source.row_pitch != 0 ? source.row_pitch : row_size));
+		}
+
+		api::resource_desc desc;
+		uint64_t size = 0;
+		std::vector<subresource_layout> subresources;
+		std::unique_ptr<uint8_t[]> data;
+	};
+
+	struct resource_view_impl
+	{
+		api::resource resource;
+		api::resource_view_desc desc;
+	};
+
+	struct framebuffer_impl
+	{
+		api::framebuffer_desc desc;
+	};
+
+	struct pipeline_layout_impl
+	{
+		std::vector<api::pipeline_layout_param> params;
+	};
+
+	struct descriptor_set_layout_impl
+	{
+		std::vector<api::descriptor_range> ranges;
+	};
+
+	struct query_pool_impl
+	{
+		std::vector<uint64_t> results;
+	};
+}
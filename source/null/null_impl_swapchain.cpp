@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#include "null_impl_device.hpp"
+#include "null_impl_command_queue.hpp"
+#include "null_impl_swapchain.hpp"
+
+reshade::null::swapchain_impl::swapchain_impl(device_impl *device, command_queue_impl *queue, uint32_t width, uint32_t height, api::format format) :
+	api_object_impl(nullptr, device, queue)
+{
+	// Report the same as a D3D11 device with feature level 11.0, to match what 'device_impl::get_api' returns
+	_renderer_id = 0xb000;
+
+	_width = width;
+	_height = height;
+	_backbuffer_format = format;
+}
+reshade::null::swapchain_impl::~swapchain_impl()
+{
+	on_reset();
+}
+
+reshade::api::resource reshade::null::swapchain_impl::get_back_buffer(uint32_t index)
+{
+	assert(index == 0);
+
+	return _backbuffer;
+}
+
+bool reshade::null::swapchain_impl::on_init(void *window)
+{
+	if (!_device->create_resource(api::resource_desc(_width, _height, 1, 1, _backbuffer_format, 1, api::memory_heap::gpu_only, api::resource_usage::render_target | api::resource_usage::copy_source), nullptr, api::resource_usage::present, &_backbuffer))
+		return false;
+
+#if RESHADE_ADDON
+	invoke_addon_event<addon_event::init_swapchain>(this);
+#endif
+
+	return runtime::on_init(window);
+}
+void reshade::null::swapchain_impl::on_reset()
+{
+	if (_backbuffer == 0)
+		return;
+
+	runtime::on_reset();
+
+#if RESHADE_ADDON
+	invoke_addon_event<addon_event::destroy_swapchain>(this);
+#endif
+
+	_device->destroy_resource(_backbuffer);
+	_backbuffer = {};
+}
+
+void reshade::null::swapchain_impl::on_present()
+{
+	if (!is_initialized())
+		return;
+
+	runtime::on_present();
+}
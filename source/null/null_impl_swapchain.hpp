@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#pragma once
+
+#include "runtime.hpp"
+
+namespace reshade::null
+{
+	class device_impl;
+	class command_queue_impl;
+
+	class swapchain_impl : public api::api_object_impl<void *, runtime>
+	{
+	public:
+		swapchain_impl(device_impl *device, command_queue_impl *queue, uint32_t width, uint32_t height, api::format format);
+		~swapchain_impl();
+
+		api::resource get_back_buffer(uint32_t index) final;
+		api::resource get_back_buffer_resolved(uint32_t index) final { return get_back_buffer(index); }
+
+		uint32_t get_back_buffer_count() const final { return 1; }
+		uint32_t get_current_back_buffer_index() const final { return 0; }
+
+		bool on_init(void *window);
+		void on_reset();
+
+		void on_present();
+
+	private:
+		api::resource _backbuffer = {};
+	};
+}
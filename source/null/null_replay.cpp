@@ -0,0 +1,948 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#if RESHADE_ADDON
+
+#include "dll_log.hpp"
+#include "null_replay.hpp"
+#include "null_impl_device.hpp"
+#include "null_impl_objects.hpp"
+#include "null_impl_command_queue.hpp"
+#include "null_impl_swapchain.hpp"
+#include "../../examples/api_capture/api_capture.hpp"
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace reshade;
+using namespace reshade::null;
+
+namespace
+{
+	template <typename T>
+	using handle_map = std::unordered_map<uint64_t, T>;
+
+	class replayer
+	{
+	public:
+		replayer(device_impl *device, command_queue_impl *queue, void *window, log_histogram &frame_times) :
+			_device(device), _queue(queue), _window(window), _frame_times(frame_times) {}
+		~replayer()
+		{
+			// Captures are usually stopped while the application is still running, so clean up everything that is still alive at that point
+			_swapchain.reset();
+			_command_lists.clear();
+
+			for (const auto &[captured, handle] : _framebuffers)
+			{
+				invoke_addon_event<addon_event::destroy_framebuffer>(_device, handle);
+				_device->destroy_framebuffer(handle);
+			}
+			for (const auto &[captured, handle] : _render_passes)
+			{
+				invoke_addon_event<addon_event::destroy_render_pass>(_device, handle);
+				_device->destroy_render_pass(handle);
+			}
+			for (const auto &[captured, pipeline] : _pipelines)
+			{
+				invoke_addon_event<addon_event::destroy_pipeline>(_device, pipeline.second);
+				_device->destroy_pipeline(pipeline.first, pipeline.second);
+			}
+			for (const auto &[captured, handle] : _resource_views)
+			{
+				invoke_addon_event<addon_event::destroy_resource_view>(_device, handle);
+				_device->destroy_resource_view(handle);
+			}
+			for (const auto &[captured, handle] : _resources)
+			{
+				// Back buffers belong to the swap chain, which was already destroyed above
+				if (std::find(_captured_back_buffers.begin(), _captured_back_buffers.end(), api::resource { captured }) != _captured_back_buffers.end())
+					continue;
+
+				invoke_addon_event<addon_event::destroy_resource>(_device, handle);
+				_device->destroy_resource(handle);
+			}
+			for (const auto &[captured, handle] : _samplers)
+			{
+				invoke_addon_event<addon_event::destroy_sampler>(_device, handle);
+				_device->destroy_sampler(handle);
+			}
+		}
+
+		bool replay(capture::reader &reader);
+
+	private:
+		template <typename T>
+		static T translate(const handle_map<T> &map, T handle)
+		{
+			if (const auto it = map.find(handle.handle); it != map.end())
+				return it->second;
+			return { 0 };
+		}
+		// Pipelines are stored together with their type, since that is required to destroy them again
+		static api::pipeline translate(const handle_map<std::pair<api::pipeline_stage, api::pipeline>> &map, api::pipeline handle)
+		{
+			if (const auto it = map.find(handle.handle); it != map.end())
+				return it->second.second;
+			return { 0 };
+		}
+		template <typename T>
+		T read_handle(capture::reader &reader, const handle_map<T> &map)
+		{
+			return translate(map, reader.read<T>());
+		}
+
+		const int32_t *read_box(capture::reader &reader, int32_t box[6])
+		{
+			const bool has_box = reader.read<uint8_t>() != 0;
+			for (int i = 0; i < 6; ++i)
+				box[i] = reader.read<int32_t>();
+			return has_box ? box : nullptr;
+		}
+		api::descriptor_set_update read_descriptor_update(capture::reader &reader, std::vector<uint64_t> &storage);
+
+		api::command_list *command_list(uint32_t index)
+		{
+			std::unique_ptr<command_list_impl> &cmd_list = _command_lists[index];
+			if (cmd_list == nullptr)
+				cmd_list = std::make_unique<command_list_impl>(_device);
+			return cmd_list.get();
+		}
+
+		uint8_t *scratch_memory(size_t size)
+		{
+			if (_scratch.size() < size)
+				_scratch.resize(size);
+			return _scratch.data();
+		}
+
+		device_impl *const _device;
+		command_queue_impl *const _queue;
+		void *const _window;
+		log_histogram &_frame_times;
+		std::unique_ptr<swapchain_impl> _swapchain;
+		std::vector<api::resource> _captured_back_buffers;
+		std::chrono::high_resolution_clock::time_point _last_present;
+		std::unordered_map<uint32_t, std::unique_ptr<command_list_impl>> _command_lists;
+		handle_map<api::sampler> _samplers;
+		handle_map<api::resource> _resources;
+		handle_map<api::resource_view> _resource_views;
+		handle_map<std::pair<api::pipeline_stage, api::pipeline>> _pipelines;
+		handle_map<api::render_pass> _render_passes;
+		handle_map<api::framebuffer> _framebuffers;
+		std::vector<uint8_t> _scratch;
+	};
+}
+
+api::descriptor_set_update replayer::read_descriptor_update(capture::reader &reader, std::vector<uint64_t> &storage)
+{
+	api::descriptor_set_update update;
+	update.set = { 0 }; // Descriptor sets are not tracked by any event, so cannot be translated
+	reader.read<api::descriptor_set>();
+	update.offset = reader.read<uint32_t>();
+	update.binding = reader.read<uint32_t>();
+	update.array_offset = reader.read<uint32_t>();
+	update.count = reader.read<uint32_t>();
+	update.type = reader.read<api::descriptor_type>();
+
+	// Check the count against the remaining data before resizing the storage, so that a corrupted capture cannot cause a huge allocation
+	switch (update.type)
+	{
+	case api::descriptor_type::sampler:
+		if (!reader.check_count(update.count, sizeof(api::sampler)))
+			break;
+		storage.resize(update.count);
+		for (uint32_t i = 0; i < update.count; ++i)
+			storage[i] = read_handle(reader, _samplers).handle;
+		break;
+	case api::descriptor_type::sampler_with_resource_view:
+		if (!reader.check_count(update.count, sizeof(api::sampler_with_resource_view)))
+			break;
+		storage.resize(update.count * 2);
+		for (uint32_t i = 0; i < update.count; ++i)
+		{
+			storage[i * 2 + 0] = read_handle(reader, _samplers).handle;
+			storage[i * 2 + 1] = read_handle(reader, _resource_views).handle;
+		}
+		break;
+	case api::descriptor_type::shader_resource_view:
+	case api::descriptor_type::unordered_access_view:
+		if (!reader.check_count(update.count, sizeof(api::resource_view)))
+			break;
+		storage.resize(update.count);
+		for (uint32_t i = 0; i < update.count; ++i)
+			storage[i] = read_handle(reader, _resource_views).handle;
+		break;
+	case api::descriptor_type::constant_buffer:
+		if (!reader.check_count(update.count, sizeof(api::buffer_range)))
+			break;
+		storage.resize(update.count * 3);
+		for (uint32_t i = 0; i < update.count; ++i)
+		{
+			storage[i * 3 + 0] = read_handle(reader, _resources).handle;
+			storage[i * 3 + 1] = reader.read<uint64_t>();
+			storage[i * 3 + 2] = reader.read<uint64_t>();
+		}
+		break;
+	}
+
+	// Descriptors of other types are not captured, and invalid updates should not pass a count without descriptors on
+	if (storage.empty())
+		update.count = 0;
+
+	update.descriptors = storage.data();
+	return update;
+}
+
+bool replayer::replay(capture::reader &reader)
+{
+	while (!reader.at_end())
+	{
+		const auto header = reader.read<capture::record_header>();
+		const uint8_t *const record_data = reader.read_bytes(header.size);
+		if (record_data == nullptr)
+		{
+			LOG(ERROR) << "Capture file is truncated.";
+			return false;
+		}
+
+		capture::reader args(record_data, header.size);
+
+		switch (header.type)
+		{
+		case addon_event::init_command_list:
+			_command_lists[args.read<uint32_t>()] = std::make_unique<command_list_impl>(_device);
+			break;
+		case addon_event::destroy_command_list:
+			_command_lists.erase(args.read<uint32_t>());
+			break;
+		case addon_event::init_swapchain:
+		{
+			const auto width = args.read<uint32_t>();
+			const auto height = args.read<uint32_t>();
+			const auto format = args.read<api::format>();
+
+			_swapchain = std::make_unique<swapchain_impl>(_device, _queue, width, height, format);
+			if (!_swapchain->on_init(_window))
+			{
+				LOG(ERROR) << "Failed to initialize swap chain for replay.";
+				return false;
+			}
+
+			// All back buffers of the application are mapped to the single back buffer of the replay swap chain
+			_captured_back_buffers.resize(args.read<uint32_t>());
+			for (api::resource &buffer : _captured_back_buffers)
+			{
+				buffer = args.read<api::resource>();
+				_resources[buffer.handle] = _swapchain->get_back_buffer(0);
+			}
+
+			// Effects are compiled in the background, so wait for that to finish to not measure it as part of the first frames (and do not count the calls made while loading either)
+			while (_swapchain->is_loading())
+				_swapchain->on_present();
+			_device->reset_statistics();
+
+			_last_present = std::chrono::high_resolution_clock::now();
+			break;
+		}
+		case addon_event::destroy_swapchain:
+			for (const api::resource buffer : _captured_back_buffers)
+				_resources.erase(buffer.handle);
+			_captured_back_buffers.clear();
+			_swapchain.reset();
+			break;
+		case addon_event::init_sampler:
+		{
+			const auto desc = args.read<api::sampler_desc>();
+			const auto captured = args.read<api::sampler>();
+
+			if (api::sampler handle; _device->create_sampler(desc, &handle))
+			{
+				invoke_addon_event<addon_event::init_sampler>(_device, desc, handle);
+				_samplers[captured.handle] = handle;
+			}
+			break;
+		}
+		case addon_event::destroy_sampler:
+			if (const auto it = _samplers.find(args.read<api::sampler>().handle); it != _samplers.end())
+			{
+				invoke_addon_event<addon_event::destroy_sampler>(_device, it->second);
+				_device->destroy_sampler(it->second);
+				_samplers.erase(it);
+			}
+			break;
+		case addon_event::init_resource:
+		{
+			const auto desc = args.read<api::resource_desc>();
+			args.read<uint8_t>(); // Initial data is not part of the capture
+			const auto initial_state = args.read<api::resource_usage>();
+			const auto captured = args.read<api::resource>();
+
+			if (api::resource handle; _device->create_resource(desc, nullptr, initial_state, &handle))
+			{
+				invoke_addon_event<addon_event::init_resource>(_device, desc, nullptr, initial_state, handle);
+				_resources[captured.handle] = handle;
+			}
+			break;
+		}
+		case addon_event::destroy_resource:
+			if (const auto it = _resources.find(args.read<api::resource>().handle); it != _resources.end())
+			{
+				invoke_addon_event<addon_event::destroy_resource>(_device, it->second);
+				_device->destroy_resource(it->second);
+				_resources.erase(it);
+			}
+			break;
+		case addon_event::init_resource_view:
+		{
+			const auto resource = read_handle(args, _resources);
+			const auto usage_type = args.read<api::resource_usage>();
+			const auto desc = args.read<api::resource_view_desc>();
+			const auto captured = args.read<api::resource_view>();
+
+			if (api::resource_view handle; resource.handle != 0 && _device->create_resource_view(resource, usage_type, desc, &handle))
+			{
+				invoke_addon_event<addon_event::init_resource_view>(_device, resource, usage_type, desc, handle);
+				_resource_views[captured.handle] = handle;
+			}
+			break;
+		}
+		case addon_event::destroy_resource_view:
+			if (const auto it = _resource_views.find(args.read<api::resource_view>().handle); it != _resource_views.end())
+			{
+				invoke_addon_event<addon_event::destroy_resource_view>(_device, it->second);
+				_device->destroy_resource_view(it->second);
+				_resource_views.erase(it);
+			}
+			break;
+		case addon_event::init_pipeline:
+		{
+			api::pipeline_desc desc = {};
+			desc.type = args.read<api::pipeline_stage>();
+			const auto captured = args.read<api::pipeline>();
+
+			if (api::pipeline handle; _device->create_pipeline(desc, &handle))
+			{
+				invoke_addon_event<addon_event::init_pipeline>(_device, desc, handle);
+				_pipelines[captured.handle] = { desc.type, handle };
+			}
+			break;
+		}
+		case addon_event::destroy_pipeline:
+			if (const auto it = _pipelines.find(args.read<api::pipeline>().handle); it != _pipelines.end())
+			{
+				invoke_addon_event<addon_event::destroy_pipeline>(_device, it->second.second);
+				_device->destroy_pipeline(it->second.first, it->second.second);
+				_pipelines.erase(it);
+			}
+			break;
+		case addon_event::init_render_pass:
+		{
+			const auto desc = args.read<api::render_pass_desc>();
+			const auto captured = args.read<api::render_pass>();
+
+			if (api::render_pass handle; _device->create_render_pass(desc, &handle))
+			{
+				invoke_addon_event<addon_event::init_render_pass>(_device, desc, handle);
+				_render_passes[captured.handle] = handle;
+			}
+			break;
+		}
+		case addon_event::destroy_render_pass:
+			if (const auto it = _render_passes.find(args.read<api::render_pass>().handle); it != _render_passes.end())
+			{
+				invoke_addon_event<addon_event::destroy_render_pass>(_device, it->second);
+				_device->destroy_render_pass(it->second);
+				_render_passes.erase(it);
+			}
+			break;
+		case addon_event::init_framebuffer:
+		{
+			auto desc = args.read<api::framebuffer_desc>();
+			const auto captured = args.read<api::framebuffer>();
+
+			desc.render_pass_template = translate(_render_passes, desc.render_pass_template);
+			desc.depth_stencil = translate(_resource_views, desc.depth_stencil);
+			for (api::resource_view &rtv : desc.render_targets)
+				rtv = translate(_resource_views, rtv);
+
+			if (api::framebuffer handle; _device->create_framebuffer(desc, &handle))
+			{
+				invoke_addon_event<addon_event::init_framebuffer>(_device, desc, handle);
+				_framebuffers[captured.handle] = handle;
+			}
+			break;
+		}
+		case addon_event::destroy_framebuffer:
+			if (const auto it = _framebuffers.find(args.read<api::framebuffer>().handle); it != _framebuffers.end())
+			{
+				invoke_addon_event<addon_event::destroy_framebuffer>(_device, it->second);
+				_device->destroy_framebuffer(it->second);
+				_framebuffers.erase(it);
+			}
+			break;
+		case addon_event::map_buffer_region:
+		{
+			const auto resource = read_handle(args, _resources);
+			const auto offset = args.read<uint64_t>();
+			const auto size = args.read<uint64_t>();
+			const auto access = args.read<api::map_access>();
+
+			if (void *data = nullptr; resource.handle != 0 && _device->map_buffer_region(resource, offset, size, access, &data))
+				invoke_addon_event<addon_event::map_buffer_region>(_device, resource, offset, size, access, &data);
+			break;
+		}
+		case addon_event::unmap_buffer_region:
+			if (const auto resource = read_handle(args, _resources); resource.handle != 0)
+			{
+				invoke_addon_event<addon_event::unmap_buffer_region>(_device, resource);
+				_device->unmap_buffer_region(resource);
+			}
+			break;
+		case addon_event::map_texture_region:
+		{
+			int32_t box_data[6];
+			const auto resource = read_handle(args, _resources);
+			const auto subresource = args.read<uint32_t>();
+			const int32_t *const box = read_box(args, box_data);
+			const auto access = args.read<api::map_access>();
+
+			if (api::subresource_data data; resource.handle != 0 && _device->map_texture_region(resource, subresource, box, access, &data))
+				invoke_addon_event<addon_event::map_texture_region>(_device, resource, subresource, box, access, &data);
+			break;
+		}
+		case addon_event::unmap_texture_region:
+		{
+			const auto resource = read_handle(args, _resources);
+			const auto subresource = args.read<uint32_t>();
+
+			if (resource.handle != 0)
+			{
+				invoke_addon_event<addon_event::unmap_texture_region>(_device, resource, subresource);
+				_device->unmap_texture_region(resource, subresource);
+			}
+			break;
+		}
+		case addon_event::update_buffer_region:
+		{
+			const auto resource = read_handle(args, _resources);
+			const auto offset = args.read<uint64_t>();
+			const auto size = args.read<uint64_t>();
+
+			if (resource.handle == 0)
+				break;
+
+			// The capture does not contain the data, so the scratch memory is sized after the region, which has to lie within the buffer
+			const auto impl = reinterpret_cast<const resource_impl *>(resource.handle);
+			if (impl->desc.type != api::resource_type::buffer || offset > impl->size || size > impl->size - offset)
+			{
+				args.invalidate();
+				break;
+			}
+
+			const void *const data = scratch_memory(static_cast<size_t>(size));
+			if (!invoke_addon_event<addon_event::update_buffer_region>(_device, data, resource, offset, size))
+				_device->update_buffer_region(data, resource, offset, size);
+			break;
+		}
+		case addon_event::update_texture_region:
+		{
+			int32_t box_data[6];
+			const auto resource = read_handle(args, _resources);
+			const auto subresource = args.read<uint32_t>();
+			const int32_t *const box = read_box(args, box_data);
+
+			api::subresource_data data;
+			data.row_pitch = args.read<uint32_t>();
+			data.slice_pitch = args.read<uint32_t>();
+
+			if (resource.handle == 0)
+				break;
+
+			// Size the source data after the whole subresource, which covers any box inside it too
+			const auto impl = reinterpret_cast<const resource_impl *>(resource.handle);
+			if (subresource >= impl->subresources.size())
+				break;
+			const resource_impl::subresource_layout &layout = impl->subresources[subresource];
+			// The capture does not contain the texel data either, so limit the pitches to those of the subresource, which bounds the scratch memory by its size
+			data.row_pitch = std::min(data.row_pitch, layout.row_pitch);
+			data.slice_pitch = std::min(data.slice_pitch, layout.slice_pitch);
+			data.data = scratch_memory(static_cast<size_t>(static_cast<uint64_t>(layout.slice_pitch) * layout.depth));
+
+			if (!invoke_addon_event<addon_event::update_texture_region>(_device, data, resource, subresource, box))
+				_device->update_texture_region(data, resource, subresource, box);
+			break;
+		}
+		case addon_event::update_descriptor_sets:
+		{
+			const auto count = args.read<uint32_t>();
+			// Every update is at least as large as its header, so check the count against that before allocating
+			if (!args.check_count(count, sizeof(api::descriptor_set) + 4 * sizeof(uint32_t) + sizeof(api::descriptor_type)))
+				break;
+
+			std::vector<api::descriptor_set_update> updates(count);
+			std::vector<std::vector<uint64_t>> storage(count);
+			for (uint32_t i = 0; i < count; ++i)
+				updates[i] = read_descriptor_update(args, storage[i]);
+
+			if (!invoke_addon_event<addon_event::update_descriptor_sets>(_device, count, updates.data()))
+				_device->update_descriptor_sets(count, updates.data());
+			break;
+		}
+		case addon_event::barrier:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			std::vector<api::resource> resources = args.read_array<api::resource>();
+			const auto old_states = args.read_array<api::resource_usage>();
+			const auto new_states = args.read_array<api::resource_usage>();
+			for (api::resource &resource : resources)
+				resource = translate(_resources, resource);
+
+			const uint32_t count = static_cast<uint32_t>(resources.size());
+			invoke_addon_event<addon_event::barrier>(cmd_list, count, resources.data(), old_states.data(), new_states.data());
+			cmd_list->barrier(count, resources.data(), old_states.data(), new_states.data());
+			break;
+		}
+		case addon_event::begin_render_pass:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto pass = read_handle(args, _render_passes);
+			const auto fbo = read_handle(args, _framebuffers);
+
+			invoke_addon_event<addon_event::begin_render_pass>(cmd_list, pass, fbo);
+			cmd_list->begin_render_pass(pass, fbo);
+			break;
+		}
+		case addon_event::finish_render_pass:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+
+			invoke_addon_event<addon_event::finish_render_pass>(cmd_list);
+			cmd_list->finish_render_pass();
+			break;
+		}
+		case addon_event::bind_render_targets_and_depth_stencil:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			std::vector<api::resource_view> rtvs = args.read_array<api::resource_view>();
+			const auto dsv = read_handle(args, _resource_views);
+			for (api::resource_view &rtv : rtvs)
+				rtv = translate(_resource_views, rtv);
+
+			const uint32_t count = static_cast<uint32_t>(rtvs.size());
+			invoke_addon_event<addon_event::bind_render_targets_and_depth_stencil>(cmd_list, count, rtvs.data(), dsv);
+			cmd_list->bind_render_targets_and_depth_stencil(count, rtvs.data(), dsv);
+			break;
+		}
+		case addon_event::bind_pipeline:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto type = args.read<api::pipeline_stage>();
+			const auto pipeline = translate(_pipelines, args.read<api::pipeline>());
+
+			invoke_addon_event<addon_event::bind_pipeline>(cmd_list, type, pipeline);
+			cmd_list->bind_pipeline(type, pipeline);
+			break;
+		}
+		case addon_event::bind_pipeline_states:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto states = args.read_array<api::dynamic_state>();
+			const auto values = args.read_array<uint32_t>();
+
+			const uint32_t count = static_cast<uint32_t>(states.size());
+			invoke_addon_event<addon_event::bind_pipeline_states>(cmd_list, count, states.data(), values.data());
+			cmd_list->bind_pipeline_states(count, states.data(), values.data());
+			break;
+		}
+		case addon_event::bind_viewports:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto first = args.read<uint32_t>();
+			const auto viewports = args.read_array<float>();
+
+			const uint32_t count = static_cast<uint32_t>(viewports.size() / 6);
+			invoke_addon_event<addon_event::bind_viewports>(cmd_list, first, count, viewports.data());
+			cmd_list->bind_viewports(first, count, viewports.data());
+			break;
+		}
+		case addon_event::bind_scissor_rects:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto first = args.read<uint32_t>();
+			const auto rects = args.read_array<int32_t>();
+
+			const uint32_t count = static_cast<uint32_t>(rects.size() / 4);
+			invoke_addon_event<addon_event::bind_scissor_rects>(cmd_list, first, count, rects.data());
+			cmd_list->bind_scissor_rects(first, count, rects.data());
+			break;
+		}
+		case addon_event::push_constants:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto stages = args.read<api::shader_stage>();
+			args.read<api::pipeline_layout>(); // Pipeline layouts are not tracked by any event, so cannot be translated
+			const auto layout_param = args.read<uint32_t>();
+			const auto first = args.read<uint32_t>();
+			const auto values = args.read_array<uint32_t>();
+
+			const uint32_t count = static_cast<uint32_t>(values.size());
+			invoke_addon_event<addon_event::push_constants>(cmd_list, stages, api::pipeline_layout { 0 }, layout_param, first, count, values.data());
+			cmd_list->push_constants(stages, api::pipeline_layout { 0 }, layout_param, first, count, values.data());
+			break;
+		}
+		case addon_event::push_descriptors:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto stages = args.read<api::shader_stage>();
+			args.read<api::pipeline_layout>();
+			const auto layout_param = args.read<uint32_t>();
+
+			std::vector<uint64_t> storage;
+			const api::descriptor_set_update update = read_descriptor_update(args, storage);
+
+			invoke_addon_event<addon_event::push_descriptors>(cmd_list, stages, api::pipeline_layout { 0 }, layout_param, update);
+			cmd_list->push_descriptors(stages, api::pipeline_layout { 0 }, layout_param, update);
+			break;
+		}
+		case addon_event::bind_descriptor_sets:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto stages = args.read<api::shader_stage>();
+			args.read<api::pipeline_layout>();
+			const auto first = args.read<uint32_t>();
+			std::vector<api::descriptor_set> sets = args.read_array<api::descriptor_set>();
+			for (api::descriptor_set &set : sets)
+				set = { 0 };
+
+			const uint32_t count = static_cast<uint32_t>(sets.size());
+			invoke_addon_event<addon_event::bind_descriptor_sets>(cmd_list, stages, api::pipeline_layout { 0 }, first, count, sets.data());
+			cmd_list->bind_descriptor_sets(stages, api::pipeline_layout { 0 }, first, count, sets.data());
+			break;
+		}
+		case addon_event::bind_index_buffer:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto buffer = read_handle(args, _resources);
+			const auto offset = args.read<uint64_t>();
+			const auto index_size = args.read<uint32_t>();
+
+			invoke_addon_event<addon_event::bind_index_buffer>(cmd_list, buffer, offset, index_size);
+			cmd_list->bind_index_buffer(buffer, offset, index_size);
+			break;
+		}
+		case addon_event::bind_vertex_buffers:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto first = args.read<uint32_t>();
+			std::vector<api::resource> buffers = args.read_array<api::resource>();
+			const auto offsets = args.read_array<uint64_t>();
+			const auto strides = args.read_array<uint32_t>();
+			for (api::resource &buffer : buffers)
+				buffer = translate(_resources, buffer);
+
+			const uint32_t count = static_cast<uint32_t>(buffers.size());
+			invoke_addon_event<addon_event::bind_vertex_buffers>(cmd_list, first, count, buffers.data(), offsets.data(), strides.data());
+			cmd_list->bind_vertex_buffers(first, count, buffers.data(), offsets.data(), strides.data());
+			break;
+		}
+		case addon_event::draw:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto vertex_count = args.read<uint32_t>();
+			const auto instance_count = args.read<uint32_t>();
+			const auto first_vertex = args.read<uint32_t>();
+			const auto first_instance = args.read<uint32_t>();
+
+			if (!invoke_addon_event<addon_event::draw>(cmd_list, vertex_count, instance_count, first_vertex, first_instance))
+				cmd_list->draw(vertex_count, instance_count, first_vertex, first_instance);
+			break;
+		}
+		case addon_event::draw_indexed:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto index_count = args.read<uint32_t>();
+			const auto instance_count = args.read<uint32_t>();
+			const auto first_index = args.read<uint32_t>();
+			const auto vertex_offset = args.read<int32_t>();
+			const auto first_instance = args.read<uint32_t>();
+
+			if (!invoke_addon_event<addon_event::draw_indexed>(cmd_list, index_count, instance_count, first_index, vertex_offset, first_instance))
+				cmd_list->draw_indexed(index_count, instance_count, first_index, vertex_offset, first_instance);
+			break;
+		}
+		case addon_event::dispatch:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto group_count_x = args.read<uint32_t>();
+			const auto group_count_y = args.read<uint32_t>();
+			const auto group_count_z = args.read<uint32_t>();
+
+			if (!invoke_addon_event<addon_event::dispatch>(cmd_list, group_count_x, group_count_y, group_count_z))
+				cmd_list->dispatch(group_count_x, group_count_y, group_count_z);
+			break;
+		}
+		case addon_event::draw_or_dispatch_indirect:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto type = args.read<api::indirect_command>();
+			const auto buffer = read_handle(args, _resources);
+			const auto offset = args.read<uint64_t>();
+			const auto draw_count = args.read<uint32_t>();
+			const auto stride = args.read<uint32_t>();
+
+			if (!invoke_addon_event<addon_event::draw_or_dispatch_indirect>(cmd_list, type, buffer, offset, draw_count, stride))
+				cmd_list->draw_or_dispatch_indirect(type, buffer, offset, draw_count, stride);
+			break;
+		}
+		case addon_event::copy_resource:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto source = read_handle(args, _resources);
+			const auto dest = read_handle(args, _resources);
+
+			if (source.handle == 0 || dest.handle == 0)
+				break;
+
+			if (!invoke_addon_event<addon_event::copy_resource>(cmd_list, source, dest))
+				cmd_list->copy_resource(source, dest);
+			break;
+		}
+		case addon_event::copy_buffer_region:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto source = read_handle(args, _resources);
+			const auto source_offset = args.read<uint64_t>();
+			const auto dest = read_handle(args, _resources);
+			const auto dest_offset = args.read<uint64_t>();
+			const auto size = args.read<uint64_t>();
+
+			if (source.handle == 0 || dest.handle == 0)
+				break;
+
+			if (!invoke_addon_event<addon_event::copy_buffer_region>(cmd_list, source, source_offset, dest, dest_offset, size))
+				cmd_list->copy_buffer_region(source, source_offset, dest, dest_offset, size);
+			break;
+		}
+		case addon_event::copy_buffer_to_texture:
+		{
+			int32_t dest_box_data[6];
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto source = read_handle(args, _resources);
+			const auto source_offset = args.read<uint64_t>();
+			const auto row_length = args.read<uint32_t>();
+			const auto slice_height = args.read<uint32_t>();
+			const auto dest = read_handle(args, _resources);
+			const auto dest_subresource = args.read<uint32_t>();
+			const int32_t *const dest_box = read_box(args, dest_box_data);
+
+			if (!invoke_addon_event<addon_event::copy_buffer_to_texture>(cmd_list, source, source_offset, row_length, slice_height, dest, dest_subresource, dest_box))
+				cmd_list->copy_buffer_to_texture(source, source_offset, row_length, slice_height, dest, dest_subresource, dest_box);
+			break;
+		}
+		case addon_event::copy_texture_region:
+		{
+			int32_t source_box_data[6], dest_box_data[6];
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto source = read_handle(args, _resources);
+			const auto source_subresource = args.read<uint32_t>();
+			const int32_t *const source_box = read_box(args, source_box_data);
+			const auto dest = read_handle(args, _resources);
+			const auto dest_subresource = args.read<uint32_t>();
+			const int32_t *const dest_box = read_box(args, dest_box_data);
+			const auto filter = args.read<api::filter_mode>();
+
+			if (!invoke_addon_event<addon_event::copy_texture_region>(cmd_list, source, source_subresource, source_box, dest, dest_subresource, dest_box, filter))
+				cmd_list->copy_texture_region(source, source_subresource, source_box, dest, dest_subresource, dest_box, filter);
+			break;
+		}
+		case addon_event::copy_texture_to_buffer:
+		{
+			int32_t source_box_data[6];
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto source = read_handle(args, _resources);
+			const auto source_subresource = args.read<uint32_t>();
+			const int32_t *const source_box = read_box(args, source_box_data);
+			const auto dest = read_handle(args, _resources);
+			const auto dest_offset = args.read<uint64_t>();
+			const auto row_length = args.read<uint32_t>();
+			const auto slice_height = args.read<uint32_t>();
+
+			if (!invoke_addon_event<addon_event::copy_texture_to_buffer>(cmd_list, source, source_subresource, source_box, dest, dest_offset, row_length, slice_height))
+				cmd_list->copy_texture_to_buffer(source, source_subresource, source_box, dest, dest_offset, row_length, slice_height);
+			break;
+		}
+		case addon_event::resolve_texture_region:
+		{
+			int32_t source_box_data[6], dest_offset_data[3];
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto source = read_handle(args, _resources);
+			const auto source_subresource = args.read<uint32_t>();
+			const int32_t *const source_box = read_box(args, source_box_data);
+			const auto dest = read_handle(args, _resources);
+			const auto dest_subresource = args.read<uint32_t>();
+			const bool has_dest_offset = args.read<uint8_t>() != 0;
+			for (int i = 0; i < 3; ++i)
+				dest_offset_data[i] = args.read<int32_t>();
+			const int32_t *const dest_offset = has_dest_offset ? dest_offset_data : nullptr;
+			const auto format = args.read<api::format>();
+
+			if (!invoke_addon_event<addon_event::resolve_texture_region>(cmd_list, source, source_subresource, source_box, dest, dest_subresource, dest_offset, format))
+				cmd_list->resolve_texture_region(source, source_subresource, source_box, dest, dest_subresource, dest_offset, format);
+			break;
+		}
+		case addon_event::clear_attachments:
+		{
+			float color[4];
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto clear_flags = args.read<api::attachment_type>();
+			for (int i = 0; i < 4; ++i)
+				color[i] = args.read<float>();
+			const auto depth = args.read<float>();
+			const auto stencil = args.read<uint8_t>();
+			const auto rects = args.read_array<int32_t>();
+
+			const uint32_t rect_count = static_cast<uint32_t>(rects.size() / 4);
+			if (!invoke_addon_event<addon_event::clear_attachments>(cmd_list, clear_flags, color, depth, stencil, rect_count, rects.data()))
+				cmd_list->clear_attachments(clear_flags, color, depth, stencil, rect_count, rects.data());
+			break;
+		}
+		case addon_event::clear_depth_stencil_view:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto dsv = read_handle(args, _resource_views);
+			const auto clear_flags = args.read<api::attachment_type>();
+			const auto depth = args.read<float>();
+			const auto stencil = args.read<uint8_t>();
+			const auto rects = args.read_array<int32_t>();
+
+			const uint32_t rect_count = static_cast<uint32_t>(rects.size() / 4);
+			if (!invoke_addon_event<addon_event::clear_depth_stencil_view>(cmd_list, dsv, clear_flags, depth, stencil, rect_count, rects.data()))
+				cmd_list->clear_depth_stencil_view(dsv, clear_flags, depth, stencil, rect_count, rects.data());
+			break;
+		}
+		case addon_event::clear_render_target_view:
+		{
+			float color[4];
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto rtv = read_handle(args, _resource_views);
+			for (int i = 0; i < 4; ++i)
+				color[i] = args.read<float>();
+			const auto rects = args.read_array<int32_t>();
+
+			const uint32_t rect_count = static_cast<uint32_t>(rects.size() / 4);
+			if (!invoke_addon_event<addon_event::clear_render_target_view>(cmd_list, rtv, color, rect_count, rects.data()))
+				cmd_list->clear_render_target_view(rtv, color, rect_count, rects.data());
+			break;
+		}
+		case addon_event::clear_unordered_access_view_uint:
+		{
+			uint32_t values[4];
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto uav = read_handle(args, _resource_views);
+			for (int i = 0; i < 4; ++i)
+				values[i] = args.read<uint32_t>();
+			const auto rects = args.read_array<int32_t>();
+
+			const uint32_t rect_count = static_cast<uint32_t>(rects.size() / 4);
+			if (!invoke_addon_event<addon_event::clear_unordered_access_view_uint>(cmd_list, uav, values, rect_count, rects.data()))
+				cmd_list->clear_unordered_access_view_uint(uav, values, rect_count, rects.data());
+			break;
+		}
+		case addon_event::clear_unordered_access_view_float:
+		{
+			float values[4];
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto uav = read_handle(args, _resource_views);
+			for (int i = 0; i < 4; ++i)
+				values[i] = args.read<float>();
+			const auto rects = args.read_array<int32_t>();
+
+			const uint32_t rect_count = static_cast<uint32_t>(rects.size() / 4);
+			if (!invoke_addon_event<addon_event::clear_unordered_access_view_float>(cmd_list, uav, values, rect_count, rects.data()))
+				cmd_list->clear_unordered_access_view_float(uav, values, rect_count, rects.data());
+			break;
+		}
+		case addon_event::generate_mipmaps:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			const auto srv = read_handle(args, _resource_views);
+
+			if (!invoke_addon_event<addon_event::generate_mipmaps>(cmd_list, srv))
+				cmd_list->generate_mipmaps(srv);
+			break;
+		}
+		case addon_event::reset_command_list:
+			invoke_addon_event<addon_event::reset_command_list>(command_list(args.read<uint32_t>()));
+			break;
+		case addon_event::execute_command_list:
+			invoke_addon_event<addon_event::execute_command_list>(_queue, command_list(args.read<uint32_t>()));
+			break;
+		case addon_event::execute_secondary_command_list:
+		{
+			api::command_list *const cmd_list = command_list(args.read<uint32_t>());
+			api::command_list *const secondary_cmd_list = command_list(args.read<uint32_t>());
+
+			invoke_addon_event<addon_event::execute_secondary_command_list>(cmd_list, secondary_cmd_list);
+			break;
+		}
+		case addon_event::present:
+		{
+			if (_swapchain == nullptr)
+				break;
+
+			invoke_addon_event<addon_event::present>(_queue, _swapchain.get());
+			_swapchain->on_present();
+
+			const auto now = std::chrono::high_resolution_clock::now();
+			_frame_times.record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - _last_present).count());
+			_last_present = now;
+			break;
+		}
+		default:
+			LOG(ERROR) << "Capture file contains unknown record type " << static_cast<uint32_t>(header.type) << '.';
+			return false;
+		}
+
+		if (args.overflowed())
+		{
+			LOG(ERROR) << "Capture file contains a record that is smaller than expected or invalid for type " << static_cast<uint32_t>(header.type) << '.';
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool reshade::null::replay_capture(const std::filesystem::path &path, device_impl *device, command_queue_impl *queue, void *window, log_histogram &frame_times)
+{
+	// Read the entire file up front, so that file access does not show up in the timings
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		LOG(ERROR) << "Failed to open capture file " << path << '!';
+		return false;
+	}
+
+	std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char *>(data.data()), data.size());
+
+	capture::reader reader(data.data(), data.size());
+
+	const auto header = reader.read<capture::file_header>();
+	if (header.magic != capture::MAGIC || header.version != capture::VERSION)
+	{
+		LOG(ERROR) << "File " << path << " is not a capture file or was written by an incompatible version.";
+		return false;
+	}
+
+	LOG(INFO) << "Replaying capture " << path << " (recorded with device API " << std::hex << static_cast<uint32_t>(header.device_api) << std::dec << ") on the null device ...";
+
+	return replayer(device, queue, window, frame_times).replay(reader);
+}
+
+#endif
@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2021 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#pragma once
+
+#include "log_histogram.hpp"
+#include <filesystem>
+
+namespace reshade::null
+{
+	class device_impl;
+	class command_queue_impl;
+
+	/// <summary>
+	/// Replays a capture recorded by the API Capture example add-on on the specified null device.
+	/// Every recorded call is issued like a hook would for the original application call: Add-on events are invoked first and the call is only passed on to the device if no add-on handled it.
+	/// Present calls render effects through a swap chain created for the recorded back buffer size, so that the runtime overhead is included as well.
+	/// </summary>
+	/// <param name="path">Path to the capture file.</param>
+	/// <param name="device">Device to replay the capture on.</param>
+	/// <param name="queue">Command queue of that device to present through.</param>
+	/// <param name="window">Window the swap chain is associated with.</param>
+	/// <param name="frame_times">Histogram that receives the CPU time of every replayed frame in nanoseconds.</param>
+	/// <returns><see langword="true"/> if the capture was replayed completely, <see langword="false"/> if it could not be read or is invalid.</returns>
+	bool replay_capture(const std::filesystem::path &path, device_impl *device, command_queue_impl *queue, void *window, log_histogram &frame_times);
+}
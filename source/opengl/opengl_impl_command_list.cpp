@@ -1048,10 +1048,8 @@ void reshade::opengl::device_impl::resolve_texture_region(api::resource src, uin
 	copy_texture_region(src, src_subresource, src_box, dst, dst_subresource, dst_box, api::filter_mode::min_mag_mip_point);
 }
 
-void reshade::opengl::device_impl::clear_attachments(api::attachment_type clear_flags, const float color[4], float depth, uint8_t stencil, uint32_t rect_count, const int32_t *)
+void reshade::opengl::device_impl::clear_attachments(api::attachment_type clear_flags, const float color[4], float depth, uint8_t stencil, uint32_t rect_count, const int32_t *rects)
 {
-	assert(rect_count == 0);
-
 	// Get current state
 	GLfloat prev_col[4];
 	glGetFloatv(GL_COLOR_CLEAR_VALUE, prev_col);
@@ -1066,7 +1064,29 @@ void reshade::opengl::device_impl::clear_attachments(api::attachment_type clear_
 	glClearDepth(depth);
 	glClearStencil(stencil);
 
-	glClear(convert_aspect_to_buffer_bits(clear_flags));
+	if (rect_count == 0)
+	{
+		glClear(convert_aspect_to_buffer_bits(clear_flags));
+	}
+	else
+	{
+		// Clears are affected by the scissor test, so use that to restrict them to the rectangles
+		const GLboolean prev_scissor_test = glIsEnabledi(GL_SCISSOR_TEST, 0);
+		GLint prev_scissor_box[4];
+		glGetIntegeri_v(GL_SCISSOR_BOX, 0, prev_scissor_box);
+
+		glEnablei(GL_SCISSOR_TEST, 0);
+
+		for (uint32_t i = 0, k = 0; i < rect_count; ++i, k += 4)
+		{
+			glScissorIndexed(0, rects[k + 0], rects[k + 1], rects[k + 2] - rects[k + 0], rects[k + 3] - rects[k + 1]);
+			glClear(convert_aspect_to_buffer_bits(clear_flags));
+		}
+
+		glScissorIndexed(0, prev_scissor_box[0], prev_scissor_box[1], prev_scissor_box[2], prev_scissor_box[3]);
+		if (!prev_scissor_test)
+			glDisablei(GL_SCISSOR_TEST, 0);
+	}
 
 	// Restore previous state from application
 	if (color != nullptr)
@@ -14,6 +14,7 @@
 #include "effect_preprocessor.hpp"
 #include "input.hpp"
 #include "input_freepie.hpp"
+#include "file_watcher.hpp"
 #include "com_ptr.hpp"
 #include <set>
 #include <thread>
@@ -50,6 +51,76 @@ bool resolve_preset_path(std::filesystem::path &path)
 	return !resolve_path(path) || ini_file::load_cache(path).has({}, "Techniques");
 }
 
+static_assert(sizeof(reshade::shared_uniform_data) == reshadefx::shared_uniform_block_size);
+static_assert(
+	offsetof(reshade::shared_uniform_data, frame_time) == reshadefx::shared_uniform_slots[0].offset &&
+	offsetof(reshade::shared_uniform_data, timer) == reshadefx::shared_uniform_slots[1].offset &&
+	offsetof(reshade::shared_uniform_data, frame_count_int) == reshadefx::shared_uniform_slots[2].offset &&
+	offsetof(reshade::shared_uniform_data, frame_count_uint) == reshadefx::shared_uniform_slots[3].offset &&
+	offsetof(reshade::shared_uniform_data, date_float) == reshadefx::shared_uniform_slots[4].offset &&
+	offsetof(reshade::shared_uniform_data, date_int) == reshadefx::shared_uniform_slots[5].offset &&
+	offsetof(reshade::shared_uniform_data, mouse_point) == reshadefx::shared_uniform_slots[6].offset &&
+	offsetof(reshade::shared_uniform_data, overlay_open) == reshadefx::shared_uniform_slots[7].offset);
+
+// Checks whether the contents of a texture only have to live within the passes of a single technique
+// That is the case if the first pass of the only technique using it overwrites it completely, so that nothing depends on its contents from before (e.g. the previous frame)
+static bool is_transient_texture(const reshadefx::module &module, const reshadefx::texture_info &info)
+{
+	if (!info.semantic.empty() || !info.render_target || info.storage_access || std::any_of(info.annotations.begin(), info.annotations.end(),
+			[](const reshadefx::annotation &annotation) { return annotation.name == "source"; }))
+		return false;
+
+	const reshadefx::technique_info *user = nullptr;
+
+	for (const reshadefx::technique_info &tech : module.techniques)
+	{
+		for (const reshadefx::pass_info &pass : tech.passes)
+		{
+			const bool reads = std::any_of(pass.samplers.begin(), pass.samplers.end(),
+				[&info](const reshadefx::sampler_info &sampler) { return sampler.texture_name == info.unique_name; });
+			const bool writes = std::find(std::begin(pass.render_target_names), std::end(pass.render_target_names), info.unique_name) != std::end(pass.render_target_names);
+			if (!reads && !writes)
+				continue;
+
+			// Only the first pass that accesses the texture in a technique matters
+			if (user == &tech)
+				continue;
+			// Contents may be passed on to a different technique
+			if (user != nullptr)
+				return false;
+			user = &tech;
+
+			if (reads || !writes)
+				return false;
+			// Techniques that skip frames or only update one band of the texture per frame rely on the contents from previous frames
+			if (std::any_of(tech.annotations.begin(), tech.annotations.end(),
+					[](const reshadefx::annotation &annotation) {
+						return (annotation.name == "update_interval" || annotation.name == "interleave") &&
+							(annotation.type.is_integral() ? annotation.value.as_int[0] : static_cast<int>(annotation.value.as_float[0])) > 1;
+					}))
+				return false;
+			// Passes that do not write every pixel keep some of the previous contents, unless they clear the render targets first
+			// This cannot detect pixel shaders that discard pixels or vertex shaders that do not cover the whole screen, which is why pooling is opt-in
+			if (!pass.clear_render_targets && (pass.blend_enable || pass.stencil_enable || pass.color_write_mask != 0xF || pass.num_vertices != 3))
+				return false;
+		}
+	}
+
+	return user != nullptr;
+}
+
+// Checks whether a render target size is derived from the back buffer size, which is the case if it is the same integer multiple or fraction of it in both dimensions
+static bool is_back_buffer_relative_size(uint32_t width, uint32_t height, uint32_t buffer_width, uint32_t buffer_height)
+{
+	if (width == 0 || height == 0 || buffer_width == 0 || buffer_height == 0)
+		return false;
+
+	if (width >= buffer_width)
+		return width % buffer_width == 0 && height == (width / buffer_width) * buffer_height;
+	else
+		return buffer_width % width == 0 && buffer_height == (buffer_width / width) * height;
+}
+
 static bool find_file(const std::vector<std::filesystem::path> &search_paths, std::filesystem::path &path)
 {
 	std::error_code ec;
@@ -75,6 +146,50 @@ static std::vector<std::filesystem::path> find_files(const std::vector<std::file
 	return files;
 }
 
+static bool technique_references_texture(const reshadefx::technique_info &info, const std::string &unique_name)
+{
+	return std::any_of(info.passes.begin(), info.passes.end(), [&unique_name](const reshadefx::pass_info &pass_info) {
+		return
+			std::find(std::begin(pass_info.render_target_names), std::end(pass_info.render_target_names), unique_name) != std::end(pass_info.render_target_names) ||
+			std::any_of(pass_info.samplers.begin(), pass_info.samplers.end(), [&unique_name](const reshadefx::sampler_info &sampler) { return sampler.texture_name == unique_name; }) ||
+			std::any_of(pass_info.storages.begin(), pass_info.storages.end(), [&unique_name](const reshadefx::storage_info &storage) { return storage.texture_name == unique_name; });
+	});
+}
+
+static bool is_technique_compiled(const reshade::effect &effect, const reshadefx::technique_info &info)
+{
+	return std::all_of(info.passes.begin(), info.passes.end(), [&effect](const reshadefx::pass_info &pass_info) {
+		if (!pass_info.cs_entry_point.empty())
+			return effect.assembly.find(pass_info.cs_entry_point) != effect.assembly.end();
+		return effect.assembly.find(pass_info.vs_entry_point) != effect.assembly.end() && effect.assembly.find(pass_info.ps_entry_point) != effect.assembly.end();
+	});
+}
+
+template <typename F>
+static void parallel_for(size_t count, size_t max_threads, F func)
+{
+	if (count == 0)
+		return;
+
+	// Hand out work items one by one, so that expensive items do not hold up a whole batch
+	std::atomic<size_t> next_index = 0;
+	const auto worker = [&next_index, count, &func]() {
+		for (size_t i; (i = next_index++) < count;)
+			func(i);
+	};
+
+	// The calling thread participates as well, so only need to spawn additional threads for the rest
+	std::vector<std::thread> threads;
+	for (size_t n = 1; n < std::min(count, max_threads); ++n)
+		threads.emplace_back(worker);
+
+	worker();
+
+	// Wait for all work items to finish before returning
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
 reshade::runtime::runtime(api::device *device, api::command_queue *graphics_queue) :
 	_device(device),
 	_graphics_queue(graphics_queue),
@@ -208,6 +323,20 @@ bool reshade::runtime::on_init(input::window_handle window)
 		}
 	}
 
+	// Create constant buffer for uniform values that are the same for all effects (except in D3D9, which does not have constant buffers)
+	if (_shared_cb == 0 && _renderer_id != 0x9000)
+	{
+		if (!_device->create_resource(
+			api::resource_desc(reshadefx::shared_uniform_block_size, api::memory_heap::cpu_to_gpu, api::resource_usage::constant_buffer),
+			nullptr, api::resource_usage::cpu_access, &_shared_cb))
+		{
+			LOG(ERROR) << "Failed to create shared constant buffer!";
+			goto exit_failure;
+		}
+
+		_device->set_resource_name(_shared_cb, "ReShade shared constant buffer");
+	}
+
 	// Create render passes for the back buffer
 	for (uint32_t i = 0; i < get_back_buffer_count(); ++i)
 	{
@@ -353,6 +482,9 @@ exit_failure:
 	_device->destroy_resource_view(_empty_texture_view);
 	_empty_texture_view = {};
 
+	_device->destroy_resource(_shared_cb);
+	_shared_cb = {};
+
 #if RESHADE_GUI
 	if (_is_vr)
 		deinit_gui_vr();
@@ -372,6 +504,8 @@ void reshade::runtime::on_reset()
 
 	// Already performs a wait for idle, so no need to do it again before destroying resources below
 	destroy_effects();
+	// Cached effect variants were compiled for the old back buffer dimensions, so they cannot be reused anymore
+	trim_effect_variant_cache(0);
 
 	_width = _height = 0;
 
@@ -406,6 +540,9 @@ void reshade::runtime::on_reset()
 	_device->destroy_resource_view(_empty_texture_view);
 	_empty_texture_view = {};
 
+	_device->destroy_resource(_shared_cb);
+	_shared_cb = {};
+
 #if RESHADE_GUI
 	if (_is_vr)
 		deinit_gui_vr();
@@ -444,10 +581,15 @@ void reshade::runtime::on_present()
 		save_screenshot(std::wstring(), true);
 
 	_framecount++;
+	_last_frame_barrier_count = _barrier_count;
+	_barrier_count = 0;
 	const auto current_time = std::chrono::high_resolution_clock::now();
 	_last_frame_duration = current_time - _last_present_time;
 	_last_present_time = current_time;
 
+	if (_framecount > 1) // There is no previous present to measure against on the first frame
+		update_frame_statistics();
+
 #ifdef NDEBUG
 	// Lock input so it cannot be modified by other threads while we are reading it here
 	const auto input_lock = _input->lock();
@@ -563,10 +705,19 @@ void reshade::runtime::load_config()
 	config.get("GENERAL", "NoReloadOnInit", _no_reload_on_init);
 	config.get("GENERAL", "NoReloadOnInitForNonVR", _no_reload_for_non_vr);
 
+	config.get("GENERAL", "CreateEffectsInBackground", _create_effects_in_background);
+	config.get("GENERAL", "EffectCreationBudget", _reload_create_budget);
 	config.get("GENERAL", "EffectSearchPaths", _effect_search_paths);
+	config.get("GENERAL", "EffectVariantCacheSize", _effect_variant_cache_size);
+	config.get("GENERAL", "FrameBudget", _frame_budget);
+	config.get("GENERAL", "LazyTextureAllocation", _lazy_texture_allocation);
 	config.get("GENERAL", "PerformanceMode", _performance_mode);
+	config.get("GENERAL", "PoolTransientTextures", _pool_transient_textures);
 	config.get("GENERAL", "PreprocessorDefinitions", _global_preprocessor_definitions);
+	config.get("GENERAL", "ReloadOnFileChange", _reload_on_file_change);
+	config.get("GENERAL", "SkipCompilingDisabledTechniques", _technique_compile_skipping);
 	config.get("GENERAL", "SkipLoadingDisabledEffects", _effect_load_skipping);
+	config.get("GENERAL", "TextureReleaseDelay", _texture_release_delay);
 	config.get("GENERAL", "TextureSearchPaths", _texture_search_paths);
 	config.get("GENERAL", "IntermediateCachePath", _intermediate_cache_path);
 
@@ -615,10 +766,19 @@ void reshade::runtime::save_config() const
 	config.set("GENERAL", "NoReloadOnInit", _no_reload_on_init);
 	config.set("GENERAL", "NoReloadOnInitForNonVR", _no_reload_for_non_vr);
 
+	config.set("GENERAL", "CreateEffectsInBackground", _create_effects_in_background);
+	config.set("GENERAL", "EffectCreationBudget", _reload_create_budget);
 	config.set("GENERAL", "EffectSearchPaths", _effect_search_paths);
+	config.set("GENERAL", "EffectVariantCacheSize", _effect_variant_cache_size);
+	config.set("GENERAL", "FrameBudget", _frame_budget);
+	config.set("GENERAL", "LazyTextureAllocation", _lazy_texture_allocation);
 	config.set("GENERAL", "PerformanceMode", _performance_mode);
+	config.set("GENERAL", "PoolTransientTextures", _pool_transient_textures);
 	config.set("GENERAL", "PreprocessorDefinitions", _global_preprocessor_definitions);
+	config.set("GENERAL", "ReloadOnFileChange", _reload_on_file_change);
+	config.set("GENERAL", "SkipCompilingDisabledTechniques", _technique_compile_skipping);
 	config.set("GENERAL", "SkipLoadingDisabledEffects", _effect_load_skipping);
+	config.set("GENERAL", "TextureReleaseDelay", _texture_release_delay);
 	config.set("GENERAL", "TextureSearchPaths", _texture_search_paths);
 	config.set("GENERAL", "IntermediateCachePath", _intermediate_cache_path);
 
@@ -933,8 +1093,11 @@ void reshade::runtime::enable_technique(technique &tech)
 	tech.enabled = true;
 	tech.time_left = tech.annotation_as_int("timeout");
 
+	// Compile technique in the background first if it was skipped during loading, it is queued for initialization once that finished
+	if (tech.passes_data.empty() && !is_technique_compiled(_effects[tech.effect_index], tech))
+		compile_technique(tech);
 	// Queue effect file for initialization if it was not fully loaded yet
-	if (tech.passes_data.empty() &&
+	else if (tech.passes_data.empty() &&
 		// Avoid adding the same effect multiple times to the queue if it contains multiple techniques that were enabled simultaneously
 		std::find(_reload_create_queue.begin(), _reload_create_queue.end(), tech.effect_index) == _reload_create_queue.end())
 		_reload_create_queue.push_back(tech.effect_index);
@@ -951,10 +1114,62 @@ void reshade::runtime::disable_technique(technique &tech)
 	tech.time_left = 0;
 	tech.average_cpu_duration.clear();
 	tech.average_gpu_duration.clear();
+	tech.budget_state.average_duration = 0.0f;
 
 	if (status_changed) // Decrease rendering reference count
 		_effects[tech.effect_index].rendering--;
 }
+void reshade::runtime::compile_technique(technique &tech)
+{
+	if (tech.compiling)
+		return; // Technique is already being compiled
+
+	const effect &effect = _effects[tech.effect_index];
+
+	// Gather entry points used by this technique that have not been compiled yet
+	std::vector<size_t> entry_points;
+	for (size_t i = 0; i < effect.module.entry_points.size(); ++i)
+	{
+		const std::string &name = effect.module.entry_points[i].name;
+
+		if (effect.assembly.find(name) == effect.assembly.end() &&
+			std::find_if(tech.passes.begin(), tech.passes.end(), [&name](const reshadefx::pass_info &pass_info) {
+				return pass_info.vs_entry_point == name || pass_info.ps_entry_point == name || pass_info.cs_entry_point == name; }) != tech.passes.end())
+			entry_points.push_back(i);
+	}
+
+	tech.compiling = true;
+	_reload_remaining_techniques++;
+
+	// Results are picked up by 'update_effects' on the render thread, so that the assembly map is never modified while it may be read
+	_worker_threads.emplace_back([this, effect_index = tech.effect_index, name = tech.name, entry_points = std::move(entry_points)]() {
+		const reshade::effect &effect = _effects[effect_index];
+
+		compiled_technique result;
+		result.effect_index = effect_index;
+		result.name = name;
+		result.success = true;
+		result.assembly.resize(entry_points.size());
+
+		std::vector<std::string> errors(entry_points.size());
+		std::unique_ptr<bool[]> results(new bool[entry_points.size()]);
+		parallel_for(entry_points.size(), std::thread::hardware_concurrency(), [&](size_t i) {
+			auto &assembly = result.assembly[i];
+			assembly.first = effect.module.entry_points[entry_points[i]].name;
+			results[i] = compile_effect_entry_point(effect, entry_points[i], assembly.second.first, assembly.second.second, errors[i]);
+		});
+
+		for (size_t i = 0; i < entry_points.size() && result.success; ++i)
+		{
+			result.errors += errors[i];
+			result.success = results[i];
+		}
+
+		const std::unique_lock<std::mutex> lock(_reload_mutex);
+		_reload_compiled_techniques.push_back(std::move(result));
+		_reload_remaining_techniques--;
+	});
+}
 
 bool reshade::runtime::load_effect(const std::filesystem::path &source_file, const ini_file &preset, size_t effect_index, bool preprocess_required)
 {
@@ -1030,6 +1245,24 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 		}
 	}
 
+	// Reuse a recently compiled variant of this effect with the same source hash instead of compiling it again (see 'reload_effects')
+	if (!effect.preprocessed && !preprocess_required)
+	{
+		const std::unique_lock<std::mutex> lock(_reload_mutex);
+
+		if (const auto it = std::find_if(_effect_variant_cache.begin(), _effect_variant_cache.end(),
+			[&source_file, source_hash](const reshade::effect &variant) { return variant.source_hash == source_hash && variant.source_file == source_file; });
+			it != _effect_variant_cache.end())
+		{
+			effect = std::move(*it);
+			_effect_variant_cache.erase(it);
+
+			// Effect indices shift when files are added or removed between reloads, so update those captured in the uniforms
+			for (uniform &variable : effect.uniforms)
+				variable.effect_index = effect_index;
+		}
+	}
+
 	bool source_cached = false; std::string source;
 	if (!effect.preprocessed && (preprocess_required || (source_cached = load_effect_cache(source_file.stem().u8string() + '-' + std::to_string(_renderer_id) + '-' + std::to_string(source_hash), "i", source)) == false))
 	{
@@ -1183,10 +1416,74 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 					variable.special = special_uniform::overlay_active;
 				else if (special == "ui_hovered" || special == "overlay_hovered")
 					variable.special = special_uniform::overlay_hovered;
+				else if (special == "render_scale")
+					variable.special = special_uniform::render_scale;
+				else if (special == "phase")
+					variable.special = special_uniform::phase;
 
 				effect.uniforms.push_back(std::move(variable));
 			}
 
+			// Resolve special uniform sources and their parameters once here, so that updating them every frame does not need to look up any annotations (see 'render_effects')
+			effect.special_uniforms.clear();
+
+			for (size_t uniform_index = 0; uniform_index < effect.uniforms.size(); ++uniform_index)
+			{
+				const uniform &variable = effect.uniforms[uniform_index];
+
+				// Values in the shared constant buffer are updated for all effects at once
+				if (variable.in_shared_block)
+					continue;
+
+				special_uniform_update update;
+				update.source = variable.special;
+				update.uniform_index = uniform_index;
+
+				switch (variable.special)
+				{
+				case special_uniform::none:
+					continue;
+				case special_uniform::random:
+					update.int_range[0] = variable.annotation_as_int("min", 0, 0);
+					update.int_range[1] = variable.annotation_as_int("max", 0, RAND_MAX);
+					break;
+				case special_uniform::ping_pong:
+					update.range[0] = variable.annotation_as_float("min", 0, 0.0f);
+					update.range[1] = variable.annotation_as_float("max", 0, 1.0f);
+					update.step[0] = variable.annotation_as_float("step", 0);
+					update.step[1] = variable.annotation_as_float("step", 1);
+					update.smoothing = variable.annotation_as_float("smoothing");
+					break;
+				case special_uniform::key:
+				case special_uniform::mouse_button:
+					update.index = variable.annotation_as_int("keycode");
+					if (variable.special == special_uniform::key ? (update.index <= 7 || update.index >= 256) : (update.index < 0 || update.index >= 5))
+						continue; // Ignore variables with an invalid key code, since those are never updated
+					if (const std::string_view mode = variable.annotation_as_string("mode");
+						mode == "toggle" || variable.annotation_as_int("toggle"))
+						update.mode = special_uniform_update::key_mode::toggle;
+					else if (mode == "press")
+						update.mode = special_uniform_update::key_mode::press;
+					break;
+				case special_uniform::mouse_wheel:
+					update.range[0] = variable.annotation_as_float("min");
+					update.range[1] = variable.annotation_as_float("max");
+					update.step[0] = variable.annotation_as_float("step");
+					if (update.step[0] == 0.0f)
+						update.step[0]  = 1.0f;
+					break;
+				case special_uniform::freepie:
+					update.index = variable.annotation_as_int("index");
+					break;
+				}
+
+				effect.special_uniforms.push_back(update);
+			}
+
+			// Group by source, so that variables with the same source are updated one after another
+			std::stable_sort(effect.special_uniforms.begin(), effect.special_uniforms.end(),
+				[](const special_uniform_update &lhs, const special_uniform_update &rhs) { return lhs.source < rhs.source; });
+
 			// Fill all specialization constants with values from the current preset
 			if (_performance_mode && effect.module.spirv.empty())
 			{
@@ -1246,269 +1543,80 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 
 	if ( effect.compiled && (effect.preprocessed || source_cached))
 	{
-		// Compile shader modules
-		for (const reshadefx::entry_point &entry_point : effect.module.entry_points)
+		if (!_device->check_capability(api::device_caps::compute_shader) &&
+			std::find_if(effect.module.entry_points.begin(), effect.module.entry_points.end(),
+				[](const reshadefx::entry_point &entry_point) { return entry_point.type == reshadefx::shader_type::cs; }) != effect.module.entry_points.end())
 		{
-			if (entry_point.type == reshadefx::shader_type::cs && !_device->check_capability(api::device_caps::compute_shader))
-			{
-				effect.errors += "Compute shaders are not supported in D3D9.";
-				effect.compiled = false;
-				break;
-			}
-
-			auto &assembly = effect.assembly[entry_point.name];
-			std::string &cso = assembly.first;
-			std::string &cso_text = assembly.second;
+			effect.errors += "Compute shaders are not supported in D3D9.";
+			effect.compiled = false;
+		}
+		else
+		{
+			std::vector<size_t> entry_points;
+			entry_points.reserve(effect.module.entry_points.size());
 
-			if (!effect.module.spirv.empty())
+			if (_technique_compile_skipping && !_load_option_disable_skipping)
 			{
-				assert(_renderer_id >= 0x14600); // Core since OpenGL 4.6 (see https://www.khronos.org/opengl/wiki/SPIR-V)
-
-				// There are various issues with SPIR-V modules that have multiple entry points on all major GPU vendors.
-				// On AMD for instance creating a graphics pipeline just fails with a generic VK_ERROR_OUT_OF_HOST_MEMORY. On NVIDIA artifacts occur on some driver versions.
-				// To work around these problems, create a separate shader module for every entry point and rewrite the SPIR-V module for each to removes all but a single entry point (and associated functions/variables).
-				uint32_t current_function = 0, current_function_offset = 0;
-				std::vector<uint32_t> spirv = effect.module.spirv;
-				std::vector<uint32_t> functions_to_remove, variables_to_remove;
+				std::vector<std::string> techniques;
+				preset.get({}, "Techniques", techniques);
 
-				for (uint32_t inst = 5 /* Skip SPIR-V header information */; inst < spirv.size();)
+				// Only compile entry points used by techniques that are enabled, the others are compiled in 'compile_technique' when their technique is enabled later
+				for (size_t i = 0; i < effect.module.entry_points.size(); ++i)
 				{
-					const uint32_t op = spirv[inst] & 0xFFFF;
-					const uint32_t len = (spirv[inst] >> 16) & 0xFFFF;
-					assert(len != 0);
+					const std::string &name = effect.module.entry_points[i].name;
 
-					switch (op)
+					for (const reshadefx::technique_info &info : effect.module.techniques)
 					{
-					case 15: // OpEntryPoint
-						// Look for any non-matching entry points
-						if (entry_point.name != reinterpret_cast<const char *>(&spirv[inst + 3]))
-						{
-							functions_to_remove.push_back(spirv[inst + 2]);
-
-							// Get interface variables
-							for (uint32_t k = inst + 3 + static_cast<uint32_t>((strlen(reinterpret_cast<const char *>(&spirv[inst + 3])) + 4) / 4); k < inst + len; ++k)
-								variables_to_remove.push_back(spirv[k]);
-
-							// Remove this entry point from the module
-							spirv.erase(spirv.begin() + inst, spirv.begin() + inst + len);
-							continue;
-						}
-						break;
-					case 16: // OpExecutionMode
-						if (std::find(functions_to_remove.begin(), functions_to_remove.end(), spirv[inst + 1]) != functions_to_remove.end())
-						{
-							spirv.erase(spirv.begin() + inst, spirv.begin() + inst + len);
-							continue;
-						}
-						break;
-					case 59: // OpVariable
-						// Remove all declarations of the interface variables for non-matching entry points
-						if (std::find(variables_to_remove.begin(), variables_to_remove.end(), spirv[inst + 2]) != variables_to_remove.end())
-						{
-							spirv.erase(spirv.begin() + inst, spirv.begin() + inst + len);
-							continue;
-						}
-						break;
-					case 71: // OpDecorate
-						// Remove all decorations targeting any of the interface variables for non-matching entry points
-						if (std::find(variables_to_remove.begin(), variables_to_remove.end(), spirv[inst + 1]) != variables_to_remove.end())
-						{
-							spirv.erase(spirv.begin() + inst, spirv.begin() + inst + len);
+						if (std::find(techniques.begin(), techniques.end(), info.name + '@' + effect_name) == techniques.end() &&
+							std::find(techniques.begin(), techniques.end(), info.name) == techniques.end() &&
+							std::find_if(info.annotations.begin(), info.annotations.end(), [](const reshadefx::annotation &annotation) {
+								return annotation.name == "enabled" && (annotation.type.is_integral() ? annotation.value.as_int[0] : static_cast<int>(annotation.value.as_float[0])) != 0; }) == info.annotations.end())
 							continue;
-						}
-						break;
-					case 54: // OpFunction
-						current_function = spirv[inst + 2];
-						current_function_offset = inst;
-						break;
-					case 56: // OpFunctionEnd
-						// Remove all function definitions for non-matching entry points
-						if (std::find(functions_to_remove.begin(), functions_to_remove.end(), current_function) != functions_to_remove.end())
+
+						if (std::find_if(info.passes.begin(), info.passes.end(), [&name](const reshadefx::pass_info &pass_info) {
+								return pass_info.vs_entry_point == name || pass_info.ps_entry_point == name || pass_info.cs_entry_point == name; }) != info.passes.end())
 						{
-							spirv.erase(spirv.begin() + current_function_offset, spirv.begin() + inst + len);
-							inst = current_function_offset;
-							continue;
+							entry_points.push_back(i);
+							break;
 						}
-						break;
 					}
-
-					inst += len;
-				}
-
-				cso.resize(spirv.size() * sizeof(uint32_t));
-				std::memcpy(cso.data(), spirv.data(), cso.size());
-			}
-			else if (_renderer_id & 0x10000)
-			{
-				cso = "#version 430\n#define ENTRY_POINT_" + entry_point.name + " 1\n";
-
-				if (entry_point.type == reshadefx::shader_type::vs)
-				{
-					// OpenGL does not allow using 'discard' in the vertex shader profile
-					cso += "#define discard\n";
-					// 'dFdx', 'dFdx' and 'fwidth' too are only available in fragment shaders
-					cso += "#define dFdx(x) x\n";
-					cso += "#define dFdy(y) y\n";
-					cso += "#define fwidth(p) p\n";
-				}
-				if (entry_point.type != reshadefx::shader_type::cs)
-				{
-					// OpenGL does not allow using 'shared' in vertex/fragment shader profile
-					cso += "#define shared\n";
-					cso += "#define atomicAdd(a, b) a\n";
-					cso += "#define atomicAnd(a, b) a\n";
-					cso += "#define atomicOr(a, b) a\n";
-					cso += "#define atomicXor(a, b) a\n";
-					cso += "#define atomicMin(a, b) a\n";
-					cso += "#define atomicMax(a, b) a\n";
-					cso += "#define atomicExchange(a, b) a\n";
-					cso += "#define atomicCompSwap(a, b, c) a\n";
-					// Barrier intrinsics are only available in compute shaders
-					cso += "#define barrier()\n";
-					cso += "#define memoryBarrier()\n";
-					cso += "#define groupMemoryBarrier()\n";
 				}
-
-				cso += "#line 1 0\n"; // Reset line number, so it matches what is shown when viewing the generated code
-				cso += effect.module.hlsl;
 			}
 			else
 			{
-				assert(_d3d_compiler != nullptr);
-
-				// Add specialization constant defines to source code
-				const std::string hlsl =
-					"#define COLOR_PIXEL_SIZE 1.0 / " + std::to_string(_width) + ", 1.0 / " + std::to_string(_height) + "\n"
-					"#define DEPTH_PIXEL_SIZE COLOR_PIXEL_SIZE\n"
-					"#define SV_DEPTH_PIXEL_SIZE DEPTH_PIXEL_SIZE\n"
-					"#define SV_TARGET_PIXEL_SIZE COLOR_PIXEL_SIZE\n"
-					"#line 1\n" + // Reset line number, so it matches what is shown when viewing the generated code
-					effect.module.hlsl;
-
-				// Overwrite position semantic in pixel shaders
-				const D3D_SHADER_MACRO ps_defines[] = {
-					{ "POSITION", "VPOS" }, { nullptr, nullptr }
-				};
-
-				std::string profile;
-				switch (entry_point.type)
-				{
-				case reshadefx::shader_type::vs:
-					profile = "vs";
-					break;
-				case reshadefx::shader_type::ps:
-					profile = "ps";
-					break;
-				case reshadefx::shader_type::cs:
-					profile = "cs";
-					break;
-				}
-
-				switch (_renderer_id)
-				{
-				default:
-				case D3D_FEATURE_LEVEL_11_0:
-					profile += "_5_0";
-					break;
-				case D3D_FEATURE_LEVEL_10_1:
-					profile += "_4_1";
-					break;
-				case D3D_FEATURE_LEVEL_10_0:
-					profile += "_4_0";
-					break;
-				case D3D_FEATURE_LEVEL_9_1:
-				case D3D_FEATURE_LEVEL_9_2:
-					profile += "_4_0_level_9_1";
-					break;
-				case D3D_FEATURE_LEVEL_9_3:
-					profile += "_4_0_level_9_3";
-					break;
-				case 0x9000:
-					profile += "_3_0";
-					break;
-				}
-
-				UINT compile_flags = (_performance_mode ? D3DCOMPILE_OPTIMIZATION_LEVEL3 : D3DCOMPILE_OPTIMIZATION_LEVEL1);
-				if (_renderer_id >= D3D_FEATURE_LEVEL_10_0)
-					compile_flags |= D3DCOMPILE_ENABLE_STRICTNESS;
-#ifndef NDEBUG
-				compile_flags |= D3DCOMPILE_DEBUG;
-#endif
-
-				std::string hlsl_attributes;
-				hlsl_attributes += "entrypoint=" + entry_point.name + ';';
-				hlsl_attributes += "profile=" + profile + ';';
-				hlsl_attributes += "flags=" + std::to_string(compile_flags) + ';';
-
-				const std::string cache_id =
-					effect.source_file.stem().u8string() + '-' + entry_point.name + '-' + std::to_string(_renderer_id) + '-' +
-					std::to_string(std::hash<std::string_view>()(hlsl_attributes) ^ std::hash<std::string_view>()(hlsl));
-
-				if (load_effect_cache(cache_id, "cso", cso) == false)
-				{
-					const auto D3DCompile = reinterpret_cast<pD3DCompile>(GetProcAddress(static_cast<HMODULE>(_d3d_compiler), "D3DCompile"));
-
-					com_ptr<ID3DBlob> d3d_compiled, d3d_errors;
-					const HRESULT hr = D3DCompile(
-						hlsl.data(), hlsl.size(),
-						nullptr, entry_point.type == reshadefx::shader_type::ps ? ps_defines : nullptr, nullptr,
-						entry_point.name.c_str(),
-						profile.c_str(),
-						compile_flags, 0,
-						&d3d_compiled, &d3d_errors);
-
-					std::string d3d_errors_string;
-					if (d3d_errors != nullptr) // Append warnings to the output error string as well
-						d3d_errors_string.assign(static_cast<const char *>(d3d_errors->GetBufferPointer()), d3d_errors->GetBufferSize() - 1); // Subtracting one to not append the null-terminator as well
-
-					// De-duplicate error lines (D3DCompiler sometimes repeats the same error multiple times)
-					for (size_t line_offset = 0, next_line_offset;
-						(next_line_offset = d3d_errors_string.find('\n', line_offset)) != std::string::npos; line_offset = next_line_offset + 1)
-					{
-						const std::string_view cur_line(d3d_errors_string.c_str() + line_offset, next_line_offset - line_offset);
-
-						if (const size_t end_offset = d3d_errors_string.find('\n', next_line_offset + 1);
-							end_offset != std::string::npos)
-						{
-							const std::string_view next_line(d3d_errors_string.c_str() + next_line_offset + 1, end_offset - next_line_offset - 1);
-							if (cur_line == next_line)
-							{
-								d3d_errors_string.erase(next_line_offset, end_offset - next_line_offset);
-								next_line_offset = line_offset - 1;
-							}
-						}
-
-						// Also remove D3DCompiler warnings about 'groupshared' specifier used in VS/PS modules
-						if (cur_line.find("X3579") != std::string_view::npos)
-						{
-							d3d_errors_string.erase(line_offset, next_line_offset + 1 - line_offset);
-							next_line_offset = line_offset - 1;
-						}
-					}
-
-					effect.errors += d3d_errors_string;
+				for (size_t i = 0; i < effect.module.entry_points.size(); ++i)
+					entry_points.push_back(i);
+			}
 
-					if (FAILED(hr))
-					{
-						effect.compiled = false;
-						break;
-					}
+			// Entry points of a reused effect variant were compiled before already
+			entry_points.erase(std::remove_if(entry_points.begin(), entry_points.end(),
+				[&effect](size_t i) { return effect.assembly.find(effect.module.entry_points[i].name) != effect.assembly.end(); }), entry_points.end());
 
-					cso.resize(d3d_compiled->GetBufferSize());
-					std::memcpy(cso.data(), d3d_compiled->GetBufferPointer(), cso.size());
+			const size_t num_entry_points = entry_points.size();
 
-					save_effect_cache(cache_id, "cso", cso);
-				}
+			// Insert all assembly entries up front, so that the map is not modified while entry points are compiled in parallel below
+			std::vector<std::pair<std::string, std::string> *> assembly(num_entry_points);
+			for (size_t i = 0; i < num_entry_points; ++i)
+				assembly[i] = &effect.assembly[effect.module.entry_points[entry_points[i]].name];
 
-				if (load_effect_cache(cache_id, "asm", cso_text) == false)
-				{
-					const auto D3DDisassemble = reinterpret_cast<pD3DDisassemble>(GetProcAddress(static_cast<HMODULE>(_d3d_compiler), "D3DDisassemble"));
+			// Share hardware threads between all effects that are still loading, so that the last effects in a reload get the most
+			size_t num_loading_effects = _reload_remaining_effects;
+			if (num_loading_effects == 0 || num_loading_effects == std::numeric_limits<size_t>::max())
+				num_loading_effects = 1;
+			const size_t num_threads = std::max<size_t>(std::thread::hardware_concurrency() / num_loading_effects, 1);
 
-					if (com_ptr<ID3DBlob> d3d_disassembled; SUCCEEDED(D3DDisassemble(cso.data(), cso.size(), 0, nullptr, &d3d_disassembled)))
-						cso_text.assign(static_cast<const char *>(d3d_disassembled->GetBufferPointer()), d3d_disassembled->GetBufferSize() - 1);
+			// Compile shader modules
+			std::vector<std::string> errors(num_entry_points);
+			std::unique_ptr<bool[]> results(new bool[num_entry_points]);
+			parallel_for(num_entry_points, num_threads, [&](size_t i) {
+				results[i] = compile_effect_entry_point(effect, entry_points[i], assembly[i]->first, assembly[i]->second, errors[i]);
+			});
 
-					save_effect_cache(cache_id, "asm", cso_text);
-				}
+			// Append errors in entry point order, so that the output is the same regardless of which compile finished first
+			for (size_t i = 0; i < num_entry_points && effect.compiled; ++i)
+			{
+				effect.errors += errors[i];
+				effect.compiled = results[i];
 			}
 		}
 
@@ -1563,14 +1671,19 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 				// Always make shared textures render targets, since they may be used as such in a different effect
 				existing_texture->render_target = true;
 				existing_texture->storage_access = true;
+				// Effects sharing a texture by name may pass contents between each other, so stop pooling it with unrelated effects
+				existing_texture->transient = false;
 				continue;
 			}
 
-			if (new_texture.annotation_as_int("pooled") && new_texture.semantic.empty())
+			// Textures that only live within one technique can share memory with those of other effects, since techniques never overlap
+			new_texture.transient = _pool_transient_textures && is_transient_texture(effect.module, new_texture);
+
+			if ((new_texture.annotation_as_int("pooled") || new_texture.transient) && new_texture.semantic.empty())
 			{
 				// Try to find another pooled texture to share with (and do not share within the same effect)
 				if (const auto existing_texture = std::find_if(_textures.begin(), _textures.end(),
-					[&new_texture](const auto &item) { return item.annotation_as_int("pooled") && item.effect_index != new_texture.effect_index && item.matches_description(new_texture); });
+					[&new_texture](const auto &item) { return (item.annotation_as_int("pooled") || item.transient) && item.effect_index != new_texture.effect_index && item.matches_description(new_texture); });
 					existing_texture != _textures.end())
 				{
 					// Overwrite referenced texture in samplers with the pooled one
@@ -1616,11 +1729,35 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 			_textures.push_back(std::move(new_texture));
 		}
 
+		bool needs_render_scale = std::any_of(effect.special_uniforms.begin(), effect.special_uniforms.end(),
+			[](const special_uniform_update &update) { return update.source == special_uniform::render_scale; });
+		bool needs_phase = std::any_of(effect.special_uniforms.begin(), effect.special_uniforms.end(),
+			[](const special_uniform_update &update) { return update.source == special_uniform::phase; });
+
 		for (technique new_technique : effect.module.techniques)
 		{
 			new_technique.effect_index = effect_index;
 
 			new_technique.hidden = new_technique.annotation_as_int("hidden") != 0;
+			new_technique.budget_state.scalable = new_technique.annotation_as_int("scalable") != 0;
+
+			// Effects usually only have a single technique, so use the scale of the first scalable one
+			if (needs_render_scale && new_technique.budget_state.scalable)
+			{
+				new_technique.provides_render_scale = true;
+				needs_render_scale = false;
+			}
+
+			new_technique.update_interval = static_cast<uint32_t>(std::clamp(new_technique.annotation_as_int("update_interval"), 1, 64));
+			new_technique.interleave = static_cast<uint32_t>(std::clamp(new_technique.annotation_as_int("interleave"), 1, 16));
+			// Spread techniques with the same interval across frames, so that they do not all update on the same one
+			new_technique.phase_offset = static_cast<uint32_t>(_techniques.size());
+
+			if (needs_phase && (new_technique.update_interval > 1 || new_technique.interleave > 1))
+			{
+				new_technique.provides_phase = true;
+				needs_phase = false;
+			}
 
 			if (new_technique.annotation_as_int("enabled"))
 				enable_technique(new_technique);
@@ -1653,57 +1790,348 @@ bool reshade::runtime::load_effect(const std::filesystem::path &source_file, con
 		return false;
 	}
 }
-bool reshade::runtime::create_effect(size_t effect_index)
+bool reshade::runtime::compile_effect_entry_point(const effect &effect, size_t entry_point_index, std::string &cso, std::string &cso_text, std::string &errors) const
 {
-	effect &effect = _effects[effect_index];
+	const reshadefx::entry_point &entry_point = effect.module.entry_points[entry_point_index];
 
-	// Create textures now, since they are referenced when building samplers below
-	for (texture &tex : _textures)
+	if (!effect.module.spirv.empty())
 	{
-		if (tex.resource != 0 || (
-			// Always create shared textures, since they may be in use by this effect already
-			tex.effect_index != effect_index && tex.shared.size() <= 1))
-			continue;
+		assert(_renderer_id >= 0x14600); // Core since OpenGL 4.6 (see https://www.khronos.org/opengl/wiki/SPIR-V)
 
-		if (!create_texture(tex))
+		// There are various issues with SPIR-V modules that have multiple entry points on all major GPU vendors.
+		// On AMD for instance creating a graphics pipeline just fails with a generic VK_ERROR_OUT_OF_HOST_MEMORY. On NVIDIA artifacts occur on some driver versions.
+		// To work around these problems, create a separate shader module for every entry point and rewrite the SPIR-V module for each to removes all but a single entry point (and associated functions/variables).
+		uint32_t current_function = 0, current_function_offset = 0;
+		std::vector<uint32_t> spirv = effect.module.spirv;
+		std::vector<uint32_t> functions_to_remove, variables_to_remove;
+
+		for (uint32_t inst = 5 /* Skip SPIR-V header information */; inst < spirv.size();)
 		{
-			effect.errors += "Failed to create texture " + tex.unique_name;
-			effect.compiled = false;
-			_last_reload_successfull = false;
-			return false;
+			const uint32_t op = spirv[inst] & 0xFFFF;
+			const uint32_t len = (spirv[inst] >> 16) & 0xFFFF;
+			assert(len != 0);
+
+			switch (op)
+			{
+			case 15: // OpEntryPoint
+				// Look for any non-matching entry points
+				if (entry_point.name != reinterpret_cast<const char *>(&spirv[inst + 3]))
+				{
+					functions_to_remove.push_back(spirv[inst + 2]);
+
+					// Get interface variables
+					for (uint32_t k = inst + 3 + static_cast<uint32_t>((strlen(reinterpret_cast<const char *>(&spirv[inst + 3])) + 4) / 4); k < inst + len; ++k)
+						variables_to_remove.push_back(spirv[k]);
+
+					// Remove this entry point from the module
+					spirv.erase(spirv.begin() + inst, spirv.begin() + inst + len);
+					continue;
+				}
+				break;
+			case 16: // OpExecutionMode
+				if (std::find(functions_to_remove.begin(), functions_to_remove.end(), spirv[inst + 1]) != functions_to_remove.end())
+				{
+					spirv.erase(spirv.begin() + inst, spirv.begin() + inst + len);
+					continue;
+				}
+				break;
+			case 59: // OpVariable
+				// Remove all declarations of the interface variables for non-matching entry points
+				if (std::find(variables_to_remove.begin(), variables_to_remove.end(), spirv[inst + 2]) != variables_to_remove.end())
+				{
+					spirv.erase(spirv.begin() + inst, spirv.begin() + inst + len);
+					continue;
+				}
+				break;
+			case 71: // OpDecorate
+				// Remove all decorations targeting any of the interface variables for non-matching entry points
+				if (std::find(variables_to_remove.begin(), variables_to_remove.end(), spirv[inst + 1]) != variables_to_remove.end())
+				{
+					spirv.erase(spirv.begin() + inst, spirv.begin() + inst + len);
+					continue;
+				}
+				break;
+			case 54: // OpFunction
+				current_function = spirv[inst + 2];
+				current_function_offset = inst;
+				break;
+			case 56: // OpFunctionEnd
+				// Remove all function definitions for non-matching entry points
+				if (std::find(functions_to_remove.begin(), functions_to_remove.end(), current_function) != functions_to_remove.end())
+				{
+					spirv.erase(spirv.begin() + current_function_offset, spirv.begin() + inst + len);
+					inst = current_function_offset;
+					continue;
+				}
+				break;
+			}
+
+			inst += len;
 		}
-	}
 
-	// Build specialization constants
-	std::vector<uint32_t> spec_data;
-	std::vector<uint32_t> spec_constants;
-	for (const reshadefx::uniform_info &constant : effect.module.spec_constants)
-	{
-		uint32_t id = static_cast<uint32_t>(spec_constants.size());
-		spec_data.push_back(constant.initializer_value.as_uint[0]);
-		spec_constants.push_back(id);
+		cso.resize(spirv.size() * sizeof(uint32_t));
+		std::memcpy(cso.data(), spirv.data(), cso.size());
 	}
-
-	// Create query pool for time measurements
-	if (!_device->create_query_pool(api::query_type::timestamp, static_cast<uint32_t>(effect.module.techniques.size() * 2 * 4), &effect.query_heap))
+	else if (_renderer_id & 0x10000)
 	{
-		effect.compiled = false;
-		_last_reload_successfull = false;
+		cso = "#version 430\n#define ENTRY_POINT_" + entry_point.name + " 1\n";
 
-		LOG(ERROR) << "Failed to create query pool for effect file " << effect.source_file << '!';
-		return false;
-	}
+		if (entry_point.type == reshadefx::shader_type::vs)
+		{
+			// OpenGL does not allow using 'discard' in the vertex shader profile
+			cso += "#define discard\n";
+			// 'dFdx', 'dFdx' and 'fwidth' too are only available in fragment shaders
+			cso += "#define dFdx(x) x\n";
+			cso += "#define dFdy(y) y\n";
+			cso += "#define fwidth(p) p\n";
+		}
+		if (entry_point.type != reshadefx::shader_type::cs)
+		{
+			// OpenGL does not allow using 'shared' in vertex/fragment shader profile
+			cso += "#define shared\n";
+			cso += "#define atomicAdd(a, b) a\n";
+			cso += "#define atomicAnd(a, b) a\n";
+			cso += "#define atomicOr(a, b) a\n";
+			cso += "#define atomicXor(a, b) a\n";
+			cso += "#define atomicMin(a, b) a\n";
+			cso += "#define atomicMax(a, b) a\n";
+			cso += "#define atomicExchange(a, b) a\n";
+			cso += "#define atomicCompSwap(a, b, c) a\n";
+			// Barrier intrinsics are only available in compute shaders
+			cso += "#define barrier()\n";
+			cso += "#define memoryBarrier()\n";
+			cso += "#define groupMemoryBarrier()\n";
+		}
 
-	const bool sampler_with_resource_view = _device->check_capability(api::device_caps::sampler_with_resource_view);
+		cso += "#line 1 0\n"; // Reset line number, so it matches what is shown when viewing the generated code
+		cso += effect.module.hlsl;
+	}
+	else
+	{
+		assert(_d3d_compiler != nullptr);
+
+		// Add specialization constant defines to source code
+		const std::string hlsl =
+			"#define COLOR_PIXEL_SIZE 1.0 / " + std::to_string(_width) + ", 1.0 / " + std::to_string(_height) + "\n"
+			"#define DEPTH_PIXEL_SIZE COLOR_PIXEL_SIZE\n"
+			"#define SV_DEPTH_PIXEL_SIZE DEPTH_PIXEL_SIZE\n"
+			"#define SV_TARGET_PIXEL_SIZE COLOR_PIXEL_SIZE\n"
+			"#line 1\n" + // Reset line number, so it matches what is shown when viewing the generated code
+			effect.module.hlsl;
+
+		// Overwrite position semantic in pixel shaders
+		const D3D_SHADER_MACRO ps_defines[] = {
+			{ "POSITION", "VPOS" }, { nullptr, nullptr }
+		};
 
-	api::descriptor_range layout_ranges[4];
+		std::string profile;
+		switch (entry_point.type)
+		{
+		case reshadefx::shader_type::vs:
+			profile = "vs";
+			break;
+		case reshadefx::shader_type::ps:
+			profile = "ps";
+			break;
+		case reshadefx::shader_type::cs:
+			profile = "cs";
+			break;
+		}
+
+		switch (_renderer_id)
+		{
+		default:
+		case D3D_FEATURE_LEVEL_11_0:
+			profile += "_5_0";
+			break;
+		case D3D_FEATURE_LEVEL_10_1:
+			profile += "_4_1";
+			break;
+		case D3D_FEATURE_LEVEL_10_0:
+			profile += "_4_0";
+			break;
+		case D3D_FEATURE_LEVEL_9_1:
+		case D3D_FEATURE_LEVEL_9_2:
+			profile += "_4_0_level_9_1";
+			break;
+		case D3D_FEATURE_LEVEL_9_3:
+			profile += "_4_0_level_9_3";
+			break;
+		case 0x9000:
+			profile += "_3_0";
+			break;
+		}
+
+		UINT compile_flags = (_performance_mode ? D3DCOMPILE_OPTIMIZATION_LEVEL3 : D3DCOMPILE_OPTIMIZATION_LEVEL1);
+		if (_renderer_id >= D3D_FEATURE_LEVEL_10_0)
+			compile_flags |= D3DCOMPILE_ENABLE_STRICTNESS;
+#ifndef NDEBUG
+		compile_flags |= D3DCOMPILE_DEBUG;
+#endif
+
+		std::string hlsl_attributes;
+		hlsl_attributes += "entrypoint=" + entry_point.name + ';';
+		hlsl_attributes += "profile=" + profile + ';';
+		hlsl_attributes += "flags=" + std::to_string(compile_flags) + ';';
+
+		const std::string cache_id =
+			effect.source_file.stem().u8string() + '-' + entry_point.name + '-' + std::to_string(_renderer_id) + '-' +
+			std::to_string(std::hash<std::string_view>()(hlsl_attributes) ^ std::hash<std::string_view>()(hlsl));
+
+		if (load_effect_cache(cache_id, "cso", cso) == false)
+		{
+			const auto D3DCompile = reinterpret_cast<pD3DCompile>(GetProcAddress(static_cast<HMODULE>(_d3d_compiler), "D3DCompile"));
+
+			com_ptr<ID3DBlob> d3d_compiled, d3d_errors;
+			const HRESULT hr = D3DCompile(
+				hlsl.data(), hlsl.size(),
+				nullptr, entry_point.type == reshadefx::shader_type::ps ? ps_defines : nullptr, nullptr,
+				entry_point.name.c_str(),
+				profile.c_str(),
+				compile_flags, 0,
+				&d3d_compiled, &d3d_errors);
+
+			std::string d3d_errors_string;
+			if (d3d_errors != nullptr) // Append warnings to the output error string as well
+				d3d_errors_string.assign(static_cast<const char *>(d3d_errors->GetBufferPointer()), d3d_errors->GetBufferSize() - 1); // Subtracting one to not append the null-terminator as well
+
+			// De-duplicate error lines (D3DCompiler sometimes repeats the same error multiple times)
+			for (size_t line_offset = 0, next_line_offset;
+				(next_line_offset = d3d_errors_string.find('\n', line_offset)) != std::string::npos; line_offset = next_line_offset + 1)
+			{
+				const std::string_view cur_line(d3d_errors_string.c_str() + line_offset, next_line_offset - line_offset);
+
+				if (const size_t end_offset = d3d_errors_string.find('\n', next_line_offset + 1);
+					end_offset != std::string::npos)
+				{
+					const std::string_view next_line(d3d_errors_string.c_str() + next_line_offset + 1, end_offset - next_line_offset - 1);
+					if (cur_line == next_line)
+					{
+						d3d_errors_string.erase(next_line_offset, end_offset - next_line_offset);
+						next_line_offset = line_offset - 1;
+					}
+				}
+
+				// Also remove D3DCompiler warnings about 'groupshared' specifier used in VS/PS modules
+				if (cur_line.find("X3579") != std::string_view::npos)
+				{
+					d3d_errors_string.erase(line_offset, next_line_offset + 1 - line_offset);
+					next_line_offset = line_offset - 1;
+				}
+			}
+
+			errors += d3d_errors_string;
+
+			if (FAILED(hr))
+				return false;
+
+			cso.resize(d3d_compiled->GetBufferSize());
+			std::memcpy(cso.data(), d3d_compiled->GetBufferPointer(), cso.size());
+
+			save_effect_cache(cache_id, "cso", cso);
+		}
+
+		if (load_effect_cache(cache_id, "asm", cso_text) == false)
+		{
+			const auto D3DDisassemble = reinterpret_cast<pD3DDisassemble>(GetProcAddress(static_cast<HMODULE>(_d3d_compiler), "D3DDisassemble"));
+
+			if (com_ptr<ID3DBlob> d3d_disassembled; SUCCEEDED(D3DDisassemble(cso.data(), cso.size(), 0, nullptr, &d3d_disassembled)))
+				cso_text.assign(static_cast<const char *>(d3d_disassembled->GetBufferPointer()), d3d_disassembled->GetBufferSize() - 1);
+
+			save_effect_cache(cache_id, "asm", cso_text);
+		}
+	}
+
+	return true;
+}
+bool reshade::runtime::create_effect(size_t effect_index)
+{
+	effect &effect = _effects[effect_index];
+
+	// Figure out which techniques still need to be created (this is called again for techniques that finish compiling in the background later)
+	std::vector<size_t> technique_indices;
+	size_t total_passes = 0, total_pass_index = 0;
+	for (size_t tech_index = 0; tech_index < _techniques.size(); ++tech_index)
+	{
+		const technique &tech = _techniques[tech_index];
+
+		if (!tech.passes_data.empty() || tech.effect_index != effect_index || !is_technique_compiled(effect, tech))
+			continue;
+		// Disabled techniques are created once they are enabled (see 'enable_technique'), so that their textures do not take up memory before
+		if (_lazy_texture_allocation && !tech.enabled)
+			continue;
+
+		technique_indices.push_back(tech_index);
+		total_passes += tech.passes.size();
+	}
+
+	if (technique_indices.empty())
+		return true;
+
+	// Create textures now, since they are referenced when building samplers below
+	for (texture &tex : _textures)
+	{
+		if (tex.resource != 0)
+			continue;
+
+		if (_lazy_texture_allocation)
+		{
+			// Only create the textures the techniques that are about to be created actually reference
+			if (std::none_of(technique_indices.begin(), technique_indices.end(),
+					[this, &tex](size_t tech_index) { return technique_references_texture(_techniques[tech_index], tex.unique_name); }))
+				continue;
+		}
+		else if (
+			// Always create shared textures, since they may be in use by this effect already
+			tex.effect_index != effect_index && tex.shared.size() <= 1)
+		{
+			continue;
+		}
+
+		if (!create_texture(tex))
+		{
+			effect.errors += "Failed to create texture " + tex.unique_name;
+			effect.compiled = false;
+			_last_reload_successfull = false;
+			return false;
+		}
+
+		tex.last_used_time = std::chrono::high_resolution_clock::now();
+	}
+
+	// Build specialization constants
+	std::vector<uint32_t> spec_data;
+	std::vector<uint32_t> spec_constants;
+	for (const reshadefx::uniform_info &constant : effect.module.spec_constants)
+	{
+		uint32_t id = static_cast<uint32_t>(spec_constants.size());
+		spec_data.push_back(constant.initializer_value.as_uint[0]);
+		spec_constants.push_back(id);
+	}
+
+	// Create query pool for time measurements, with a timestamp before the first and after every pass of each technique, for every command frame
+	size_t num_queries = 0;
+	for (const reshadefx::technique_info &info : effect.module.techniques)
+		num_queries += (info.passes.size() + 1) * 4;
+	if (effect.query_heap == 0 && !_device->create_query_pool(api::query_type::timestamp, static_cast<uint32_t>(num_queries), &effect.query_heap))
+	{
+		effect.compiled = false;
+		_last_reload_successfull = false;
+
+		LOG(ERROR) << "Failed to create query pool for effect file " << effect.source_file << '!';
+		return false;
+	}
+
+	const bool sampler_with_resource_view = _device->check_capability(api::device_caps::sampler_with_resource_view);
+
+	api::descriptor_range layout_ranges[4];
 	api::pipeline_layout_param layout_params[4];
 
 	layout_ranges[0].offset = 0;
 	layout_ranges[0].binding = 0;
-	layout_ranges[0].dx_register_index = 0; // b0 (global constant buffer)
+	layout_ranges[0].dx_register_index = 0; // b0 (global constant buffer), b1 (shared constant buffer)
 	layout_ranges[0].dx_register_space = 0;
-	layout_ranges[0].count = 1;
+	layout_ranges[0].count = _shared_cb != 0 ? 2 : 1;
 	layout_ranges[0].array_size = 1;
 	layout_ranges[0].type = api::descriptor_type::constant_buffer;
 	layout_ranges[0].visibility = api::shader_stage::all;
@@ -1735,48 +2163,53 @@ bool reshade::runtime::create_effect(size_t effect_index)
 	layout_ranges[3].type = api::descriptor_type::unordered_access_view;
 	layout_ranges[3].visibility = api::shader_stage::all;
 
-	_device->create_descriptor_set_layout(1, &layout_ranges[0], false, &effect.set_layouts[0]);
-	layout_params[0].type = api::pipeline_layout_param_type::descriptor_set;
-	layout_params[0].descriptor_layout = effect.set_layouts[0];
+	// Layouts are shared by all techniques, so only need to create them the first time
+	if (effect.layout == 0)
+	{
+		_device->create_descriptor_set_layout(1, &layout_ranges[0], false, &effect.set_layouts[0]);
+		layout_params[0].type = api::pipeline_layout_param_type::descriptor_set;
+		layout_params[0].descriptor_layout = effect.set_layouts[0];
 
-	_device->create_descriptor_set_layout(1, &layout_ranges[1], false, &effect.set_layouts[1]);
-	layout_params[1].type = api::pipeline_layout_param_type::descriptor_set;
-	layout_params[1].descriptor_layout = effect.set_layouts[1];
+		_device->create_descriptor_set_layout(1, &layout_ranges[1], false, &effect.set_layouts[1]);
+		layout_params[1].type = api::pipeline_layout_param_type::descriptor_set;
+		layout_params[1].descriptor_layout = effect.set_layouts[1];
 
-	if (sampler_with_resource_view)
-	{
-		_device->create_descriptor_set_layout(1, &layout_ranges[3], false, &effect.set_layouts[3]);
-		layout_params[2].type = api::pipeline_layout_param_type::descriptor_set;
-		layout_params[2].descriptor_layout = effect.set_layouts[3];
-	}
-	else
-	{
-		_device->create_descriptor_set_layout(1, &layout_ranges[2], false, &effect.set_layouts[2]);
-		layout_params[2].type = api::pipeline_layout_param_type::descriptor_set;
-		layout_params[2].descriptor_layout = effect.set_layouts[2];
-		_device->create_descriptor_set_layout(1, &layout_ranges[3], false, &effect.set_layouts[3]);
-		layout_params[3].type = api::pipeline_layout_param_type::descriptor_set;
-		layout_params[3].descriptor_layout = effect.set_layouts[3];
-	}
+		if (sampler_with_resource_view)
+		{
+			_device->create_descriptor_set_layout(1, &layout_ranges[3], false, &effect.set_layouts[3]);
+			layout_params[2].type = api::pipeline_layout_param_type::descriptor_set;
+			layout_params[2].descriptor_layout = effect.set_layouts[3];
+		}
+		else
+		{
+			_device->create_descriptor_set_layout(1, &layout_ranges[2], false, &effect.set_layouts[2]);
+			layout_params[2].type = api::pipeline_layout_param_type::descriptor_set;
+			layout_params[2].descriptor_layout = effect.set_layouts[2];
+			_device->create_descriptor_set_layout(1, &layout_ranges[3], false, &effect.set_layouts[3]);
+			layout_params[3].type = api::pipeline_layout_param_type::descriptor_set;
+			layout_params[3].descriptor_layout = effect.set_layouts[3];
+		}
 
-	// Create pipeline layout for this effect
-	if (!_device->create_pipeline_layout(sampler_with_resource_view ? 3 : 4, layout_params, &effect.layout))
-	{
-		effect.compiled = false;
-		_last_reload_successfull = false;
+		// Create pipeline layout for this effect
+		if (!_device->create_pipeline_layout(sampler_with_resource_view ? 3 : 4, layout_params, &effect.layout))
+		{
+			effect.compiled = false;
+			_last_reload_successfull = false;
 
-		LOG(ERROR) << "Failed to create pipeline layout for effect file " << effect.source_file << '!';
-		return false;
+			LOG(ERROR) << "Failed to create pipeline layout for effect file " << effect.source_file << '!';
+			return false;
+		}
 	}
 
 	api::buffer_range cb_range = {};
+	api::buffer_range shared_cb_range = {};
 	std::vector<api::descriptor_set_update> descriptor_writes;
-	descriptor_writes.reserve(effect.module.num_sampler_bindings + effect.module.num_texture_bindings + effect.module.num_storage_bindings + 1);
+	descriptor_writes.reserve(effect.module.num_sampler_bindings + effect.module.num_texture_bindings + effect.module.num_storage_bindings + 2);
 	std::vector<api::sampler_with_resource_view> sampler_descriptors;
 	sampler_descriptors.resize(effect.module.num_sampler_bindings + effect.module.num_texture_bindings);
 
 	// Create global constant buffer (except in D3D9, which does not have constant buffers)
-	if (_renderer_id != 0x9000 && !effect.uniform_data_storage.empty())
+	if (_renderer_id != 0x9000 && !effect.uniform_data_storage.empty() && effect.cb == 0)
 	{
 		if (!_device->create_resource(
 			api::resource_desc(effect.uniform_data_storage.size(), api::memory_heap::cpu_to_gpu, api::resource_usage::constant_buffer),
@@ -1791,6 +2224,22 @@ bool reshade::runtime::create_effect(size_t effect_index)
 
 		_device->set_resource_name(effect.cb, "ReShade constant buffer");
 
+		// Keep the buffer mapped where the API allows it, so that uniform updates can write just the modified range without having to map it every time
+		if (const api::device_api device_api = _device->get_api();
+			device_api == api::device_api::d3d12 || device_api == api::device_api::vulkan)
+			_device->map_buffer_region(effect.cb, 0, std::numeric_limits<uint64_t>::max(), api::map_access::write_only, &effect.cb_mapped);
+
+		// New buffer has no contents yet, so everything needs to be uploaded
+		effect.uniform_data_dirty_begin = 0;
+		effect.uniform_data_dirty_end = effect.uniform_data_storage.size();
+	}
+
+	// Effects that only use uniforms from the shared constant buffer still need a descriptor set to bind it, even if they have no constant buffer of their own
+	const bool uses_shared_cb = _shared_cb != 0 && std::any_of(effect.uniforms.begin(), effect.uniforms.end(),
+		[](const uniform &variable) { return variable.in_shared_block; });
+
+	if ((effect.cb != 0 || uses_shared_cb) && effect.cb_set == 0)
+	{
 		if (!_device->create_descriptor_sets(1, &effect.set_layouts[0], &effect.cb_set))
 		{
 			effect.compiled = false;
@@ -1800,24 +2249,35 @@ bool reshade::runtime::create_effect(size_t effect_index)
 			return false;
 		}
 
-		cb_range.buffer = effect.cb;
+		if (effect.cb != 0)
+		{
+			cb_range.buffer = effect.cb;
+
+			api::descriptor_set_update &write = descriptor_writes.emplace_back();
+			write.set = effect.cb_set;
+			write.offset = write.binding = 0;
+			write.type = api::descriptor_type::constant_buffer;
+			write.count = 1;
+			write.descriptors = &cb_range;
+		}
+
+		if (_shared_cb != 0)
+		{
+			shared_cb_range.buffer = _shared_cb;
 
-		api::descriptor_set_update &write = descriptor_writes.emplace_back();
-		write.set = effect.cb_set;
-		write.offset = write.binding = 0;
-		write.type = api::descriptor_type::constant_buffer;
-		write.count = 1;
-		write.descriptors = &cb_range;
+			api::descriptor_set_update &write = descriptor_writes.emplace_back();
+			write.set = effect.cb_set;
+			write.offset = write.binding = 1;
+			write.type = api::descriptor_type::constant_buffer;
+			write.count = 1;
+			write.descriptors = &shared_cb_range;
+		}
 	}
 
 	// Initialize sampler and storage bindings
-	size_t total_passes = 0, total_pass_index = 0;
-	for (const reshadefx::technique_info &info : effect.module.techniques)
-		total_passes += info.passes.size();
-
 	std::vector<api::descriptor_set> texture_tables(total_passes), storage_tables(total_passes);
 
-	if (effect.module.num_sampler_bindings != 0)
+	if (effect.module.num_sampler_bindings != 0 && (sampler_with_resource_view || effect.sampler_set == 0))
 	{
 		const std::vector<api::descriptor_set_layout> layouts(sampler_with_resource_view ? total_passes : 1, effect.set_layouts[1]);
 
@@ -1917,17 +2377,31 @@ bool reshade::runtime::create_effect(size_t effect_index)
 		}
 	}
 
-	for (size_t tech_index = 0, tech_index_in_effect = 0; tech_index < _techniques.size(); ++tech_index)
+	// Only collect pipeline descriptions while iterating the passes, so that the pipelines can be created in parallel afterwards
+	// The descriptions only point to data that stays valid until the effect is destroyed (assembly map entries and the specialization constant lists), so that this can happen on another thread too
+	struct pipeline_create_info
+	{
+		api::pipeline_desc desc;
+		api::pipeline *pipeline;
+		const reshadefx::technique_info *tech;
+		size_t pass_index;
+	};
+	std::vector<pipeline_create_info> pipelines;
+
+	for (const size_t tech_index : technique_indices)
 	{
 		technique &tech = _techniques[tech_index];
 
-		if (!tech.passes_data.empty() || tech.effect_index != effect_index)
-			continue;
-
 		tech.passes_data.resize(tech.passes.size());
 
-		// Offset index so that a query exists for each command frame and two subsequent ones are used for before/after stamps
-		tech.query_base_index = static_cast<uint32_t>(tech_index_in_effect++ * 2 * 4);
+		// Offset index so that a set of queries exists for each command frame, with subsequent ones used for the stamps in between passes
+		const size_t tech_index_in_effect = std::find_if(effect.module.techniques.begin(), effect.module.techniques.end(),
+			[&tech](const reshadefx::technique_info &info) { return info.name == tech.name; }) - effect.module.techniques.begin();
+		tech.query_base_index = 0;
+		for (size_t i = 0; i < tech_index_in_effect; ++i)
+			tech.query_base_index += static_cast<uint32_t>((effect.module.techniques[i].passes.size() + 1) * 4);
+
+		const reshadefx::technique_info &tech_info = effect.module.techniques[tech_index_in_effect];
 
 		for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index, ++total_pass_index)
 		{
@@ -1939,48 +2413,41 @@ bool reshade::runtime::create_effect(size_t effect_index)
 				api::pipeline_desc desc = { api::pipeline_stage::all_compute };
 				desc.layout = effect.layout;
 
-				const auto &cs = effect.assembly.at(pass_info.cs_entry_point).first;
-				desc.compute.shader.code = cs.data();
-				desc.compute.shader.code_size = cs.size();
+				const auto &cs = *effect.assembly.find(pass_info.cs_entry_point);
+				desc.compute.shader.code = cs.second.first.data();
+				desc.compute.shader.code_size = cs.second.first.size();
 				if (_renderer_id & 0x20000)
 				{
-					desc.compute.shader.entry_point = pass_info.cs_entry_point.c_str();
+					desc.compute.shader.entry_point = cs.first.c_str();
 					desc.compute.shader.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
 					desc.compute.shader.spec_constant_ids = spec_constants.data();
 					desc.compute.shader.spec_constant_values = spec_data.data();
 				}
 
-				if (!_device->create_pipeline(desc, &pass_data.pipeline))
-				{
-					effect.compiled = false;
-					_last_reload_successfull = false;
-
-					LOG(ERROR) << "Failed to create compute pipeline for pass " << pass_index << " in technique '" << tech.name << "' in " << effect.source_file << '!';
-					return false;
-				}
+				pipelines.push_back({ desc, &pass_data.pipeline, &tech_info, pass_index });
 			}
 			else
 			{
 				api::pipeline_desc desc = { api::pipeline_stage::all_graphics };
 				desc.layout = effect.layout;
 
-				const auto &vs = effect.assembly.at(pass_info.vs_entry_point).first;
-				desc.graphics.vertex_shader.code = vs.data();
-				desc.graphics.vertex_shader.code_size = vs.size();
+				const auto &vs = *effect.assembly.find(pass_info.vs_entry_point);
+				desc.graphics.vertex_shader.code = vs.second.first.data();
+				desc.graphics.vertex_shader.code_size = vs.second.first.size();
 				if (_renderer_id & 0x20000)
 				{
-					desc.graphics.vertex_shader.entry_point = pass_info.vs_entry_point.c_str();
+					desc.graphics.vertex_shader.entry_point = vs.first.c_str();
 					desc.graphics.vertex_shader.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
 					desc.graphics.vertex_shader.spec_constant_ids = spec_constants.data();
 					desc.graphics.vertex_shader.spec_constant_values = spec_data.data();
 				}
 
-				const auto &ps = effect.assembly.at(pass_info.ps_entry_point).first;
-				desc.graphics.pixel_shader.code = ps.data();
-				desc.graphics.pixel_shader.code_size = ps.size();
+				const auto &ps = *effect.assembly.find(pass_info.ps_entry_point);
+				desc.graphics.pixel_shader.code = ps.second.first.data();
+				desc.graphics.pixel_shader.code_size = ps.second.first.size();
 				if (_renderer_id & 0x20000)
 				{
-					desc.graphics.pixel_shader.entry_point = pass_info.ps_entry_point.c_str();
+					desc.graphics.pixel_shader.entry_point = ps.first.c_str();
 					desc.graphics.pixel_shader.spec_constants = static_cast<uint32_t>(effect.module.spec_constants.size());
 					desc.graphics.pixel_shader.spec_constant_ids = spec_constants.data();
 					desc.graphics.pixel_shader.spec_constant_values = spec_data.data();
@@ -2096,6 +2563,8 @@ bool reshade::runtime::create_effect(size_t effect_index)
 				rasterizer_state.fill_mode = api::fill_mode::solid;
 				rasterizer_state.cull_mode = api::cull_mode::none;
 				rasterizer_state.depth_clip_enable = true;
+				// Scissor rectangle always covers the viewport, except when only updating part of a render target (see 'render_technique')
+				rasterizer_state.scissor_enable = true;
 
 				const auto convert_stencil_op = [](reshadefx::pass_stencil_op value) {
 					switch (value) {
@@ -2141,14 +2610,7 @@ bool reshade::runtime::create_effect(size_t effect_index)
 				depth_stencil_state.front_stencil_pass_op = depth_stencil_state.back_stencil_pass_op;
 				depth_stencil_state.front_stencil_func = depth_stencil_state.back_stencil_func;
 
-				if (!_device->create_pipeline(desc, &pass_data.pipeline))
-				{
-					effect.compiled = false;
-					_last_reload_successfull = false;
-
-					LOG(ERROR) << "Failed to create graphics pipeline for pass " << pass_index << " in technique '" << tech.name << "' in " << effect.source_file << '!';
-					return false;
-				}
+				pipelines.push_back({ desc, &pass_data.pipeline, &tech_info, pass_index });
 			}
 
 			if (effect.module.num_sampler_bindings != 0 ||
@@ -2219,6 +2681,9 @@ bool reshade::runtime::create_effect(size_t effect_index)
 					if (texture.semantic == "COLOR")
 					{
 						srv = _backbuffer_texture_view[info.srgb];
+
+						// Only passes that sample the back buffer need the copy of it to be up to date (see 'render_technique')
+						pass_data.reads_backbuffer = true;
 					}
 					else if (!texture.semantic.empty())
 					{
@@ -2264,11 +2729,113 @@ bool reshade::runtime::create_effect(size_t effect_index)
 				}
 			}
 		}
+
+		// Precompute the barriers of every pass, so that rendering does not have to build them every frame
+		// Resources that the next pass writes in the same way are kept in their state instead of transitioning them back and forth, unless mipmaps have to be generated for them in between
+		const auto pass_usage = [&tech](size_t pass_index) {
+			return tech.passes[pass_index].cs_entry_point.empty() ? api::resource_usage::render_target : api::resource_usage::unordered_access;
+		};
+		const auto keeps_state = [this, &tech, &pass_usage](size_t pass_index, size_t next_pass_index, api::resource resource) {
+			if (next_pass_index >= tech.passes.size() || pass_usage(pass_index) != pass_usage(next_pass_index))
+				return false;
+			const technique::pass_data &pass_data = tech.passes_data[pass_index];
+			const technique::pass_data &next_pass_data = tech.passes_data[next_pass_index];
+			return
+				std::find(next_pass_data.modified_resources.begin(), next_pass_data.modified_resources.end(), resource) != next_pass_data.modified_resources.end() &&
+				std::none_of(pass_data.generate_mipmap_views.begin(), pass_data.generate_mipmap_views.end(),
+					[this, resource](api::resource_view view) { return _device->get_resource_from_view(view) == resource; });
+		};
+
+		for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
+		{
+			technique::pass_data &pass_data = tech.passes_data[pass_index];
+			const api::resource_usage usage = pass_usage(pass_index);
+
+			for (const api::resource resource : pass_data.modified_resources)
+			{
+				if (pass_index == 0 || !keeps_state(pass_index - 1, pass_index, resource))
+					pass_data.barriers_before.push_back(resource, api::resource_usage::shader_resource, usage);
+				else if (usage == api::resource_usage::unordered_access)
+					// Writes of the previous dispatch still need to finish before the next one can access the resource
+					pass_data.barriers_before.push_back(resource, api::resource_usage::unordered_access, api::resource_usage::unordered_access);
+
+				if (!keeps_state(pass_index, pass_index + 1, resource))
+					pass_data.barriers_after.push_back(resource, usage, api::resource_usage::shader_resource);
+			}
+		}
 	}
 
 	if (!descriptor_writes.empty())
 		_device->update_descriptor_sets(static_cast<uint32_t>(descriptor_writes.size()), descriptor_writes.data());
 
+	// Take over pipelines of a reused effect variant, so that only the missing ones have to be created
+	if (!effect.cached_pipelines.empty())
+	{
+		pipelines.erase(std::remove_if(pipelines.begin(), pipelines.end(),
+			[&effect](const pipeline_create_info &info) {
+				const auto it = effect.cached_pipelines.find(info.tech->name);
+				if (it == effect.cached_pipelines.end() || info.pass_index >= it->second.size() || it->second[info.pass_index] == 0)
+					return false;
+				*info.pipeline = it->second[info.pass_index];
+				it->second[info.pass_index] = {};
+				return true;
+			}), pipelines.end());
+	}
+
+	// Pipeline creation is where drivers compile shaders to native code, so spread it across threads where the device allows concurrent object creation
+	// D3D10/11 devices may have been created by the application with the single-threaded flag, which cannot be queried through the API, so only D3D12 and Vulkan are considered free-threaded
+	const api::device_api device_api = _device->get_api();
+	const bool free_threaded = device_api == api::device_api::d3d12 || device_api == api::device_api::vulkan;
+
+	const auto create_pipelines = [this, free_threaded, source_file = effect.source_file](const std::vector<pipeline_create_info> &pipelines) {
+		std::unique_ptr<bool[]> results(new bool[pipelines.size()]);
+		parallel_for(pipelines.size(), free_threaded ? std::thread::hardware_concurrency() : 1, [&](size_t i) {
+			results[i] = _device->create_pipeline(pipelines[i].desc, pipelines[i].pipeline);
+		});
+
+		for (size_t i = 0; i < pipelines.size(); ++i)
+		{
+			if (results[i])
+				continue;
+
+			LOG(ERROR) << "Failed to create " << (pipelines[i].desc.type == api::pipeline_stage::all_compute ? "compute" : "graphics") << " pipeline for pass " << pipelines[i].pass_index << " in technique '" << pipelines[i].tech->name << "' in " << source_file << '!';
+			return false;
+		}
+
+		return true;
+	};
+
+	if (_create_effects_in_background && free_threaded && !pipelines.empty())
+	{
+		created_pipelines result;
+		result.effect_index = effect_index;
+
+		// Keep the techniques from rendering until all their pipelines exist, 'update_effects' then publishes them all at once
+		for (const size_t tech_index : technique_indices)
+		{
+			_techniques[tech_index].creating = true;
+			result.technique_names.push_back(_techniques[tech_index].name);
+		}
+
+		_reload_remaining_pipelines++;
+
+		// Pipeline handles are written to the pass data of the techniques, which keeps its storage while the technique list is reordered
+		// The specialization constant lists are moved into the thread too, since the pipeline descriptions point to them
+		_worker_threads.emplace_back([this, create_pipelines, pipelines = std::move(pipelines), spec_data = std::move(spec_data), spec_constants = std::move(spec_constants), result = std::move(result)]() mutable {
+			result.success = create_pipelines(pipelines);
+
+			const std::unique_lock<std::mutex> lock(_reload_mutex);
+			_reload_created_pipelines.push_back(std::move(result));
+			_reload_remaining_pipelines--;
+		});
+	}
+	else if (!create_pipelines(pipelines))
+	{
+		effect.compiled = false;
+		_last_reload_successfull = false;
+		return false;
+	}
+
 	return true;
 }
 void reshade::runtime::destroy_effect(size_t effect_index)
@@ -2302,6 +2869,9 @@ void reshade::runtime::destroy_effect(size_t effect_index)
 
 	{	effect &effect = _effects[effect_index];
 
+		if (effect.cb_mapped != nullptr)
+			_device->unmap_buffer_region(effect.cb);
+		effect.cb_mapped = nullptr;
 		_device->destroy_resource(effect.cb);
 		effect.cb = {};
 
@@ -2323,6 +2893,8 @@ void reshade::runtime::destroy_effect(size_t effect_index)
 		effect.query_heap = {};
 
 		effect.texture_semantic_to_binding.clear();
+
+		destroy_cached_pipelines(effect);
 	}
 
 #if RESHADE_GUI
@@ -2354,6 +2926,40 @@ void reshade::runtime::destroy_effect(size_t effect_index)
 
 	// Do not clear effect here, since it is common to be re-used immediately
 }
+void reshade::runtime::destroy_cached_pipelines(effect &effect)
+{
+	for (const auto &[name, pipelines] : effect.cached_pipelines)
+	{
+		const auto tech_info = std::find_if(effect.module.techniques.begin(), effect.module.techniques.end(),
+			[&name = name](const reshadefx::technique_info &info) { return info.name == name; });
+		assert(tech_info != effect.module.techniques.end());
+
+		for (size_t pass_index = 0; pass_index < pipelines.size(); ++pass_index)
+		{
+			const bool is_compute_pass = !tech_info->passes[pass_index].cs_entry_point.empty();
+			_device->destroy_pipeline(is_compute_pass ? api::pipeline_stage::all_compute : api::pipeline_stage::all_graphics, pipelines[pass_index]);
+		}
+	}
+
+	effect.cached_pipelines.clear();
+}
+void reshade::runtime::trim_effect_variant_cache(size_t max_size)
+{
+	// Least recently used variants are at the back of the list
+	while (_effect_variant_cache.size() > max_size)
+	{
+		effect &variant = _effect_variant_cache.back();
+
+		destroy_cached_pipelines(variant);
+
+		_device->destroy_pipeline_layout(variant.layout);
+		for (int i = 0; i < 4; ++i)
+			_device->destroy_descriptor_set_layout(variant.set_layouts[i]);
+		_device->destroy_query_pool(variant.query_heap);
+
+		_effect_variant_cache.pop_back();
+	}
+}
 
 bool reshade::runtime::create_texture(texture &tex)
 {
@@ -2513,6 +3119,82 @@ void reshade::runtime::destroy_texture(texture &tex)
 
 	_device->destroy_resource_view(tex.uav);
 	tex.uav = {};
+
+	// Image has to be loaded again should the texture be created again later
+	tex.loaded = false;
+}
+void reshade::runtime::release_unused_textures()
+{
+	const auto now = std::chrono::high_resolution_clock::now();
+
+	// Going through all textures and techniques every frame is wasteful, the release delay is in seconds anyway
+	if (now - _last_texture_release_check < std::chrono::seconds(1))
+		return;
+	_last_texture_release_check = now;
+
+	std::vector<texture *> released_textures;
+	for (texture &tex : _textures)
+	{
+		if (tex.resource == 0)
+			continue;
+		// Keep textures loaded from an image file, so that it does not have to be loaded again, and textures bound to a semantic, whose views may be in use elsewhere
+		if (!tex.semantic.empty() || !tex.annotation_as_string("source").empty())
+			continue;
+
+		if (std::any_of(_techniques.begin(), _techniques.end(),
+				[&tex](const technique &tech) { return (tech.enabled || tech.creating) && technique_references_texture(tech, tex.unique_name); }))
+			tex.last_used_time = now;
+		else if (now - tex.last_used_time >= std::chrono::seconds(_texture_release_delay))
+			released_textures.push_back(&tex);
+	}
+
+	if (released_textures.empty())
+		return;
+
+	// Make sure none of these textures are currently in use
+	_device->wait_idle();
+
+	// Techniques referencing the textures are created again when they are enabled the next time, but can keep their pipelines until then
+	for (technique &tech : _techniques)
+	{
+		if (tech.passes_data.empty() || std::none_of(released_textures.begin(), released_textures.end(),
+				[&tech](const texture *tex) { return technique_references_texture(tech, tex->unique_name); }))
+			continue;
+
+		effect &effect = _effects[tech.effect_index];
+
+		std::vector<api::pipeline> &pipelines = effect.cached_pipelines[tech.name];
+		pipelines.resize(tech.passes_data.size());
+
+		for (size_t pass_index = 0; pass_index < tech.passes_data.size(); ++pass_index)
+		{
+			technique::pass_data &pass_data = tech.passes_data[pass_index];
+
+			std::swap(pipelines[pass_index], pass_data.pipeline);
+
+			_device->destroy_framebuffer(pass_data.fbo);
+			_device->destroy_render_pass(pass_data.pass);
+
+			effect.texture_semantic_to_binding.erase(std::remove_if(effect.texture_semantic_to_binding.begin(), effect.texture_semantic_to_binding.end(),
+				[&pass_data](const effect::binding_data &binding) { return binding.set == pass_data.texture_set; }), effect.texture_semantic_to_binding.end());
+
+			_device->destroy_descriptor_sets(1, &pass_data.texture_set);
+			_device->destroy_descriptor_sets(1, &pass_data.storage_set);
+		}
+
+		tech.passes_data.clear();
+	}
+
+	for (texture *tex : released_textures)
+	{
+#if RESHADE_GUI
+		if (_preview_texture == tex->srv[0])
+			_preview_texture.handle = 0;
+#endif
+		destroy_texture(*tex);
+	}
+
+	LOG(INFO) << "Released " << released_textures.size() << " texture(s) no longer referenced by any enabled technique.";
 }
 
 void reshade::runtime::load_effects()
@@ -2574,53 +3256,57 @@ void reshade::runtime::load_textures()
 
 	for (texture &texture : _textures)
 	{
-		if (texture.resource == 0 || !texture.semantic.empty())
-			continue; // Ignore textures that are not created yet and those that are handled in the runtime implementation
-
-		std::filesystem::path source_path = std::filesystem::u8path(texture.annotation_as_string("source"));
-		// Ignore textures that have no image file attached to them (e.g. plain render targets)
-		if (source_path.empty())
-			continue;
+		if (texture.resource == 0 || !texture.semantic.empty() || texture.loaded)
+			continue; // Ignore textures that are not created yet, those that are handled in the runtime implementation and those whose image file was not modified since it was last loaded
 
-		// Search for image file using the provided search paths unless the path provided is already absolute
-		if (!find_file(_texture_search_paths, source_path))
-		{
-			LOG(ERROR) << "Source " << source_path << " for texture '" << texture.unique_name << "' could not be found in any of the texture search paths!";
+		if (!load_texture(texture))
 			_last_texture_reload_successfull = false;
-			continue;
-		}
-
-		stbi_uc *filedata = nullptr;
-		int width = 0, height = 0, channels = 0;
+	}
 
-		if (FILE *file; _wfopen_s(&file, source_path.c_str(), L"rb") == 0)
-		{
-			// Read texture data into memory in one go since that is faster than reading chunk by chunk
-			std::vector<uint8_t> mem(static_cast<size_t>(std::filesystem::file_size(source_path)));
-			fread(mem.data(), 1, mem.size(), file);
-			fclose(file);
+	_textures_loaded = true;
+}
+bool reshade::runtime::load_texture(texture &texture)
+{
+	std::filesystem::path source_path = std::filesystem::u8path(texture.annotation_as_string("source"));
+	// Ignore textures that have no image file attached to them (e.g. plain render targets)
+	if (source_path.empty())
+		return true;
 
-			if (stbi_dds_test_memory(mem.data(), static_cast<int>(mem.size())))
-				filedata = stbi_dds_load_from_memory(mem.data(), static_cast<int>(mem.size()), &width, &height, &channels, STBI_rgb_alpha);
-			else
-				filedata = stbi_load_from_memory(mem.data(), static_cast<int>(mem.size()), &width, &height, &channels, STBI_rgb_alpha);
-		}
+	// Search for image file using the provided search paths unless the path provided is already absolute
+	if (!find_file(_texture_search_paths, source_path))
+	{
+		LOG(ERROR) << "Source " << source_path << " for texture '" << texture.unique_name << "' could not be found in any of the texture search paths!";
+		return false;
+	}
 
-		if (filedata == nullptr)
-		{
-			LOG(ERROR) << "Source " << source_path << " for texture '" << texture.unique_name << "' could not be loaded! Make sure it is of a compatible file format.";
-			_last_texture_reload_successfull = false;
-			continue;
-		}
+	stbi_uc *filedata = nullptr;
+	int width = 0, height = 0, channels = 0;
 
-		set_texture_data({ reinterpret_cast<uintptr_t>(&texture) }, width, height, filedata);
+	if (FILE *file; _wfopen_s(&file, source_path.c_str(), L"rb") == 0)
+	{
+		// Read texture data into memory in one go since that is faster than reading chunk by chunk
+		std::vector<uint8_t> mem(static_cast<size_t>(std::filesystem::file_size(source_path)));
+		fread(mem.data(), 1, mem.size(), file);
+		fclose(file);
 
-		stbi_image_free(filedata);
+		if (stbi_dds_test_memory(mem.data(), static_cast<int>(mem.size())))
+			filedata = stbi_dds_load_from_memory(mem.data(), static_cast<int>(mem.size()), &width, &height, &channels, STBI_rgb_alpha);
+		else
+			filedata = stbi_load_from_memory(mem.data(), static_cast<int>(mem.size()), &width, &height, &channels, STBI_rgb_alpha);
+	}
 
-		texture.loaded = true;
+	if (filedata == nullptr)
+	{
+		LOG(ERROR) << "Source " << source_path << " for texture '" << texture.unique_name << "' could not be loaded! Make sure it is of a compatible file format.";
+		return false;
 	}
 
-	_textures_loaded = true;
+	set_texture_data({ reinterpret_cast<uintptr_t>(&texture) }, width, height, filedata);
+
+	stbi_image_free(filedata);
+
+	texture.loaded = true;
+	return true;
 }
 bool reshade::runtime::reload_effect(size_t effect_index, bool preprocess_required)
 {
@@ -2628,12 +3314,110 @@ bool reshade::runtime::reload_effect(size_t effect_index, bool preprocess_requir
 	_show_splash = false; // Hide splash bar when reloading a single effect file
 #endif
 
+	// Make sure no techniques of this effect are still being compiled in the background
+	for (std::thread &thread : _worker_threads)
+		if (thread.joinable())
+			thread.join();
+	_worker_threads.clear();
+	// Discard results that were compiled from the old source
+	_reload_compiled_techniques.erase(std::remove_if(_reload_compiled_techniques.begin(), _reload_compiled_techniques.end(),
+		[effect_index](const compiled_technique &result) { return result.effect_index == effect_index; }), _reload_compiled_techniques.end());
+	_reload_created_pipelines.erase(std::remove_if(_reload_created_pipelines.begin(), _reload_created_pipelines.end(),
+		[effect_index](const created_pipelines &result) { return result.effect_index == effect_index; }), _reload_created_pipelines.end());
+
 	const std::filesystem::path source_file = _effects[effect_index].source_file;
 	destroy_effect(effect_index);
 	return load_effect(source_file, ini_file::load_cache(_current_preset_path), effect_index, preprocess_required);
 }
 void reshade::runtime::reload_effects()
 {
+	// Keep compiled effects around, so that switching back to a preset with the same preprocessor definitions does not have to compile them and create their pipelines again
+	// This is not done in performance mode, since preset values are compiled into the effects then, which the source hash does not account for
+	if (_effect_variant_cache_size != 0 && !_performance_mode)
+	{
+		// Make sure no threads are still accessing effect data
+		for (std::thread &thread : _worker_threads)
+			if (thread.joinable())
+				thread.join();
+		_worker_threads.clear();
+
+		for (size_t effect_index = 0; effect_index < _effects.size(); ++effect_index)
+		{
+			effect &effect = _effects[effect_index];
+
+			if (!effect.compiled || effect.skipped)
+				continue;
+
+			// Pooled textures may be shared with a different effect on the next load, which would change the texture references in the module
+			if (std::any_of(effect.module.textures.begin(), effect.module.textures.end(),
+					[](const reshadefx::texture_info &info) {
+						return std::find_if(info.annotations.begin(), info.annotations.end(),
+							[](const reshadefx::annotation &annotation) { return annotation.name == "pooled"; }) != info.annotations.end(); }))
+				continue;
+
+			// Effects that share a texture with other effects, or whose module was rewritten to use a pooled texture of another effect, depend on textures they do not own
+			// This is checked on the actual texture list rather than with the current pooling setting, since that may have changed since the effect was loaded
+			if (std::any_of(_textures.begin(), _textures.end(),
+					[effect_index](const texture &tex) {
+						return tex.shared.size() > 1 && std::find(tex.shared.begin(), tex.shared.end(), effect_index) != tex.shared.end(); }))
+				continue;
+
+			const auto is_owned_texture = [&effect](const std::string &texture_name) {
+				return texture_name.empty() || std::any_of(effect.module.textures.begin(), effect.module.textures.end(),
+					[&texture_name](const reshadefx::texture_info &info) { return info.unique_name == texture_name; });
+			};
+
+			if (!std::all_of(effect.module.samplers.begin(), effect.module.samplers.end(),
+					[&is_owned_texture](const reshadefx::sampler_info &info) { return is_owned_texture(info.texture_name); }) ||
+				!std::all_of(effect.module.storages.begin(), effect.module.storages.end(),
+					[&is_owned_texture](const reshadefx::storage_info &info) { return is_owned_texture(info.texture_name); }) ||
+				!std::all_of(effect.module.techniques.begin(), effect.module.techniques.end(),
+					[&is_owned_texture](const reshadefx::technique_info &info) {
+						return std::all_of(info.passes.begin(), info.passes.end(),
+							[&is_owned_texture](const reshadefx::pass_info &pass) {
+								return std::all_of(std::begin(pass.render_target_names), std::end(pass.render_target_names), is_owned_texture) &&
+									std::all_of(pass.samplers.begin(), pass.samplers.end(),
+										[&is_owned_texture](const reshadefx::sampler_info &info) { return is_owned_texture(info.texture_name); }) &&
+									std::all_of(pass.storages.begin(), pass.storages.end(),
+										[&is_owned_texture](const reshadefx::storage_info &info) { return is_owned_texture(info.texture_name); });
+							});
+					}))
+				continue;
+
+			// Take pipelines out of the techniques, so that 'destroy_effect' does not destroy them
+			for (technique &tech : _techniques)
+			{
+				if (tech.effect_index != effect_index || tech.passes_data.empty())
+					continue;
+
+				std::vector<api::pipeline> &pipelines = effect.cached_pipelines[tech.name];
+				pipelines.resize(tech.passes_data.size());
+
+				for (size_t pass_index = 0; pass_index < tech.passes_data.size(); ++pass_index)
+					std::swap(pipelines[pass_index], tech.passes_data[pass_index].pipeline);
+			}
+
+			reshade::effect variant = std::move(effect);
+			variant.rendering = 0;
+			// Objects that reference textures or uniform data are created again in 'create_effect'
+			variant.cb = {};
+			variant.cb_mapped = nullptr;
+			variant.cb_set = {};
+			variant.sampler_set = {};
+			variant.texture_semantic_to_binding.clear();
+
+			// The moved-from effect still holds the handles, so clear the ones that were handed over to the variant
+			effect.layout = {};
+			for (int i = 0; i < 4; ++i)
+				effect.set_layouts[i] = {};
+			effect.query_heap = {};
+
+			_effect_variant_cache.push_front(std::move(variant));
+		}
+
+		trim_effect_variant_cache(_effect_variant_cache_size);
+	}
+
 	// Clear out any previous effects
 	destroy_effects();
 
@@ -2643,7 +3427,81 @@ void reshade::runtime::reload_effects()
 #endif
 	_last_reload_successfull = true;
 
-	load_effects();
+	load_effects();
+}
+void reshade::runtime::reload_modified_files(const std::vector<std::filesystem::path> &modified_files)
+{
+	const auto is_modified = [&modified_files](const std::filesystem::path &path) {
+		return std::find(modified_files.begin(), modified_files.end(), path) != modified_files.end();
+	};
+
+	// Mark textures for upload again whose image file was modified, which happens in 'load_textures' the next time 'update_effects' is called
+	for (texture &tex : _textures)
+	{
+		if (!tex.loaded)
+			continue;
+
+		if (std::filesystem::path source_path = std::filesystem::u8path(tex.annotation_as_string("source"));
+			find_file(_texture_search_paths, source_path) && is_modified(source_path))
+		{
+			tex.loaded = false;
+			_textures_loaded = false;
+		}
+	}
+
+	// Find all effects that are affected by the modifications, either directly or through one of their included files
+	std::vector<size_t> effect_indices;
+	std::vector<std::filesystem::path> source_files;
+	for (size_t effect_index = 0; effect_index < _effects.size(); ++effect_index)
+	{
+		const effect &effect = _effects[effect_index];
+		if (effect.skipped || effect.source_file.empty())
+			continue;
+
+		if (is_modified(effect.source_file) || std::any_of(effect.included_files.begin(), effect.included_files.end(), is_modified))
+		{
+			effect_indices.push_back(effect_index);
+			source_files.push_back(effect.source_file);
+		}
+	}
+
+	if (effect_indices.empty())
+		return;
+
+	LOG(INFO) << "Reloading " << effect_indices.size() << " effect(s) after files were modified ...";
+
+	// Make sure no threads are still accessing effect data
+	for (std::thread &thread : _worker_threads)
+		if (thread.joinable())
+			thread.join();
+	_worker_threads.clear();
+
+	for (const size_t effect_index : effect_indices)
+	{
+		// Discard results that were compiled from the old source
+		_reload_compiled_techniques.erase(std::remove_if(_reload_compiled_techniques.begin(), _reload_compiled_techniques.end(),
+			[effect_index](const compiled_technique &result) { return result.effect_index == effect_index; }), _reload_compiled_techniques.end());
+		_reload_created_pipelines.erase(std::remove_if(_reload_created_pipelines.begin(), _reload_created_pipelines.end(),
+			[effect_index](const created_pipelines &result) { return result.effect_index == effect_index; }), _reload_created_pipelines.end());
+		_reload_create_queue.erase(std::remove(_reload_create_queue.begin(), _reload_create_queue.end(), effect_index), _reload_create_queue.end());
+
+		destroy_effect(effect_index);
+
+		// Reset effect, so that it is compiled from scratch even if the source hash did not change (e.g. because an included file outside the effect search paths was modified)
+		_effects[effect_index] = {};
+	}
+
+	_reload_remaining_effects = effect_indices.size();
+
+	// Only the affected effects are compiled again, spread over all available cores
+	// Create copy of preset instead of reference, so it stays valid even if 'ini_file::load_cache' is called while effects are still being loaded
+	_worker_threads.emplace_back([this, effect_indices = std::move(effect_indices), source_files = std::move(source_files), preset = ini_file::load_cache(_current_preset_path)]() {
+		parallel_for(effect_indices.size(), std::thread::hardware_concurrency(), [this, &effect_indices, &source_files, &preset](size_t i) {
+			// Abort loading when initialization state changes (indicating that 'on_reset' was called in the meantime)
+			if (_is_initialized)
+				load_effect(source_files[i], preset, effect_indices[i], true);
+		});
+	});
 }
 void reshade::runtime::destroy_effects()
 {
@@ -2652,6 +3510,8 @@ void reshade::runtime::destroy_effects()
 		if (thread.joinable())
 			thread.join();
 	_worker_threads.clear();
+	_reload_compiled_techniques.clear();
+	_reload_created_pipelines.clear();
 
 	for (size_t effect_index = 0; effect_index < _effects.size(); ++effect_index)
 		destroy_effect(effect_index);
@@ -2669,6 +3529,9 @@ void reshade::runtime::destroy_effects()
 	assert(_techniques.empty());
 
 	_textures_loaded = false;
+
+	// The list of watched directories depends on the loaded effects, so start over with the next load
+	_file_watcher.reset();
 }
 
 bool reshade::runtime::load_effect_cache(const std::string &id, const std::string &type, std::string &source) const
@@ -2730,6 +3593,87 @@ void reshade::runtime::update_effects()
 	if (_framecount == 0 && !_no_reload_on_init && !(_no_reload_for_non_vr && !_is_vr))
 		reload_effects();
 
+	const auto handle_create_failure = [this](size_t effect_index) {
+		// Destroy all textures belonging to this effect
+		for (texture &tex : _textures)
+			if (tex.effect_index == effect_index && tex.shared.size() <= 1)
+				destroy_texture(tex);
+		// Disable all techniques belonging to this effect
+		for (technique &tech : _techniques)
+			if (tech.effect_index == effect_index)
+				disable_technique(tech);
+
+		_last_reload_successfull = false;
+	};
+
+	// Pick up work that finished in the background (see 'compile_technique' and 'create_effect')
+	if (!is_loading())
+	{
+		// Check before taking the results, since they are added before the counters are decreased
+		const bool finished_background_work = _reload_remaining_techniques == 0 && _reload_remaining_pipelines == 0;
+
+		std::vector<compiled_technique> compiled_techniques;
+		std::vector<created_pipelines> created_pipelines_list;
+		{	const std::unique_lock<std::mutex> lock(_reload_mutex);
+			compiled_techniques.swap(_reload_compiled_techniques);
+			created_pipelines_list.swap(_reload_created_pipelines);
+		}
+
+		for (const created_pipelines &result : created_pipelines_list)
+		{
+			// Publish all techniques of this batch at once
+			for (technique &tech : _techniques)
+				if (tech.effect_index == result.effect_index && std::find(result.technique_names.begin(), result.technique_names.end(), tech.name) != result.technique_names.end())
+					tech.creating = false;
+
+			if (!result.success)
+			{
+				_effects[result.effect_index].compiled = false;
+				handle_create_failure(result.effect_index);
+			}
+		}
+
+		for (compiled_technique &result : compiled_techniques)
+		{
+			effect &effect = _effects[result.effect_index];
+			effect.errors += result.errors;
+
+			if (result.success)
+			{
+				for (auto &assembly : result.assembly)
+					effect.assembly.insert(std::move(assembly));
+
+				LOG(INFO) << "Successfully compiled technique '" << result.name << "' in " << effect.source_file << '.';
+			}
+			else
+			{
+				_last_reload_successfull = false;
+
+				LOG(ERROR) << "Failed to compile technique '" << result.name << "' in " << effect.source_file << ":\n" << result.errors;
+			}
+
+			if (const auto it = std::find_if(_techniques.begin(), _techniques.end(),
+				[&result](const technique &tech) { return tech.effect_index == result.effect_index && tech.name == result.name; });
+				it != _techniques.end())
+			{
+				it->compiling = false;
+
+				if (!result.success)
+					disable_technique(*it);
+				else if (it->enabled)
+					enable_technique(*it); // This queues the effect for initialization
+			}
+		}
+
+		if (finished_background_work && !_worker_threads.empty())
+		{
+			for (std::thread &thread : _worker_threads)
+				if (thread.joinable())
+					thread.join();
+			_worker_threads.clear();
+		}
+	}
+
 	if (_reload_remaining_effects == 0)
 	{
 		// Clear the thread list now that they all have finished
@@ -2770,48 +3714,78 @@ void reshade::runtime::update_effects()
 	}
 	else if (!_reload_create_queue.empty())
 	{
-		// Pop an effect from the queue
-		const size_t effect_index = _reload_create_queue.back();
-		_reload_create_queue.pop_back();
+		// Create as many effects as fit into the time budget of this frame, but at least one
+		const auto create_start_time = std::chrono::high_resolution_clock::now();
 
-		if (!create_effect(effect_index))
+		do
 		{
-			// Destroy all textures belonging to this effect
-			for (texture &tex : _textures)
-				if (tex.effect_index == effect_index && tex.shared.size() <= 1)
-					destroy_texture(tex);
-			// Disable all techniques belonging to this effect
-			for (technique &tech : _techniques)
-				if (tech.effect_index == effect_index)
-					disable_technique(tech);
+			// Pop an effect from the queue
+			const size_t effect_index = _reload_create_queue.back();
+			_reload_create_queue.pop_back();
 
-			_last_reload_successfull = false;
-		}
+			if (!create_effect(effect_index))
+				handle_create_failure(effect_index);
 
-		// An effect has changed, need to reload textures
-		_textures_loaded = false;
+			// An effect has changed, need to reload textures
+			_textures_loaded = false;
 
 #if RESHADE_GUI
-		effect &effect = _effects[effect_index];
+			effect &effect = _effects[effect_index];
 
-		// Update assembly in all editors after a reload
-		for (editor_instance &instance : _editors)
-		{
-			if (instance.entry_point_name.empty() || instance.file_path != effect.source_file)
-				continue;
-			assert(instance.effect_index == effect_index);
+			// Update assembly in all editors after a reload
+			for (editor_instance &instance : _editors)
+			{
+				if (instance.entry_point_name.empty() || instance.file_path != effect.source_file)
+					continue;
+				assert(instance.effect_index == effect_index);
 
-			if (const auto assembly_it = effect.assembly.find(instance.entry_point_name);
-				assembly_it != effect.assembly.end())
-				open_code_editor(instance);
-		}
+				if (const auto assembly_it = effect.assembly.find(instance.entry_point_name);
+					assembly_it != effect.assembly.end())
+					open_code_editor(instance);
+			}
 #endif
+		} while (!_reload_create_queue.empty() &&
+			std::chrono::high_resolution_clock::now() - create_start_time < std::chrono::milliseconds(_reload_create_budget));
 	}
 	else if (!_textures_loaded)
 	{
 		// Now that all effects were compiled, load all textures
 		load_textures();
 	}
+	else if (!_reload_on_file_change)
+	{
+		_file_watcher.reset();
+	}
+	else if (_reload_remaining_techniques == 0 && _reload_remaining_pipelines == 0)
+	{
+		if (_file_watcher == nullptr)
+		{
+			// Watch the search paths, as well as all directories with included files, since those may be outside the search paths
+			std::vector<std::filesystem::path> directories;
+			for (std::filesystem::path search_path : _effect_search_paths)
+				if (resolve_path(search_path))
+					directories.push_back(std::move(search_path));
+			for (std::filesystem::path search_path : _texture_search_paths)
+				if (resolve_path(search_path))
+					directories.push_back(std::move(search_path));
+			for (const effect &effect : _effects)
+				for (const std::filesystem::path &included_file : effect.included_files)
+					directories.push_back(included_file.parent_path());
+
+			std::sort(directories.begin(), directories.end());
+			directories.erase(std::unique(directories.begin(), directories.end()), directories.end());
+
+			_file_watcher = std::make_shared<file_watcher>(directories);
+		}
+
+		if (std::vector<std::filesystem::path> modified_files;
+			_file_watcher->check(modified_files))
+			reload_modified_files(modified_files);
+	}
+
+	// Free textures of techniques that were disabled a while ago
+	if (_lazy_texture_allocation && !is_loading() && _reload_create_queue.empty())
+		release_unused_textures();
 }
 void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource_view rtv, api::resource_view rtv_srgb)
 {
@@ -2834,6 +3808,81 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 		return;
 
 	// Update special uniform variables
+	// Values that are the same for all variables of a source are only computed once here
+	const float frame_time = _last_frame_duration.count() * 1e-6f;
+	const unsigned int timer_ms = static_cast<unsigned int>(std::chrono::duration_cast<std::chrono::milliseconds>(_last_present_time - _start_time).count());
+	int date[4] = {};
+	bool date_valid = false;
+
+	const auto update_date = [&date, &date_valid]() {
+		if (date_valid)
+			return;
+		const std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+		tm tm; localtime_s(&tm, &t);
+
+		date[0] = tm.tm_year + 1900;
+		date[1] = tm.tm_mon + 1;
+		date[2] = tm.tm_mday;
+		date[3] = tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec;
+		date_valid = true;
+	};
+
+	uint32_t mouse_pos_x = _input->mouse_position_x();
+	uint32_t mouse_pos_y = _input->mouse_position_y();
+#if RESHADE_GUI
+	if (mouse_pos_x > _window_width)
+		mouse_pos_x = _window_width;
+	if (mouse_pos_y > _window_height)
+		mouse_pos_y = _window_height;
+#endif
+
+	// Values that are the same for all effects are written to the shared constant buffer just once here
+	if (_shared_cb != 0)
+	{
+		shared_uniform_data &data = _shared_uniform_data;
+
+		update_date();
+
+		data.frame_time = frame_time;
+		data.timer = static_cast<float>(timer_ms);
+		data.frame_count_int = static_cast<int32_t>(_framecount % UINT_MAX);
+		data.frame_count_uint = static_cast<uint32_t>(_framecount % UINT_MAX);
+		for (int i = 0; i < 4; ++i)
+			data.date_float[i] = static_cast<float>(data.date_int[i] = date[i]);
+		data.mouse_point[0] = static_cast<float>(mouse_pos_x);
+		data.mouse_point[1] = static_cast<float>(mouse_pos_y);
+#if RESHADE_GUI
+		data.overlay_open = _show_overlay ? 1 : 0;
+#endif
+
+		if (void *mapped_data;
+			_device->map_buffer_region(_shared_cb, 0, std::numeric_limits<uint64_t>::max(), api::map_access::write_discard, &mapped_data))
+		{
+			std::memcpy(mapped_data, &_shared_uniform_data, sizeof(_shared_uniform_data));
+			_device->unmap_buffer_region(_shared_cb);
+		}
+	}
+
+	// Copy the render scale and phase of techniques to their effect, so that they do not have to be looked up for every uniform below
+	for (const technique &tech : _techniques)
+	{
+		effect &effect = _effects[tech.effect_index];
+
+		if (tech.provides_render_scale)
+			effect.render_scale = _frame_budget > 0 && tech.enabled ? tech.budget_state.scale : 1.0f;
+
+		if (tech.provides_phase)
+		{
+			// Set to the interleave band that is rendered this frame and the number of frames since the intermediate passes last ran
+			const uint32_t current_phase = tech.enabled ? tech.current_phase(_framecount) : 0;
+			effect.phase[0] = current_phase / tech.update_interval;
+			effect.phase[1] = current_phase % tech.update_interval;
+		}
+	}
+
+	// Toggle keys of variables only need to be checked when any key was pressed this frame
+	const bool check_toggle_keys = !_ignore_shortcuts && _input->is_any_key_pressed();
+
 	for (effect &effect : _effects)
 	{
 		if (!effect.rendering)
@@ -2841,42 +3890,47 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 
 		for (uniform &variable : effect.uniforms)
 		{
-			if (!_ignore_shortcuts && _input->is_key_pressed(variable.toggle_key_data, _force_shortcut_modifiers))
-			{
-				assert(variable.supports_toggle_key());
+			if (!check_toggle_keys || !_input->is_key_pressed(variable.toggle_key_data, _force_shortcut_modifiers))
+				continue;
+
+			assert(variable.supports_toggle_key());
 
-				// Change to next value if the associated shortcut key was pressed
-				switch (variable.type.base)
+			// Change to next value if the associated shortcut key was pressed
+			switch (variable.type.base)
+			{
+				case reshadefx::type::t_bool:
 				{
-					case reshadefx::type::t_bool:
-					{
-						bool data;
-						get_uniform_value(variable, &data, 1);
-						set_uniform_value(variable, !data);
-						break;
-					}
-					case reshadefx::type::t_int:
-					case reshadefx::type::t_uint:
-					{
-						int data[4];
-						get_uniform_value(variable, data, 4);
-						const std::string_view ui_items = variable.annotation_as_string("ui_items");
-						int num_items = 0;
-						for (size_t offset = 0, next; (next = ui_items.find('\0', offset)) != std::string::npos; offset = next + 1)
-							num_items++;
-						data[0] = (data[0] + 1 >= num_items) ? 0 : data[0] + 1;
-						set_uniform_value(variable, data, 4);
-						break;
-					}
+					bool data;
+					get_uniform_value(variable, &data, 1);
+					set_uniform_value(variable, !data);
+					break;
+				}
+				case reshadefx::type::t_int:
+				case reshadefx::type::t_uint:
+				{
+					int data[4];
+					get_uniform_value(variable, data, 4);
+					const std::string_view ui_items = variable.annotation_as_string("ui_items");
+					int num_items = 0;
+					for (size_t offset = 0, next; (next = ui_items.find('\0', offset)) != std::string::npos; offset = next + 1)
+						num_items++;
+					data[0] = (data[0] + 1 >= num_items) ? 0 : data[0] + 1;
+					set_uniform_value(variable, data, 4);
+					break;
 				}
-				save_current_preset();
 			}
+			save_current_preset();
+		}
 
-			switch (variable.special)
+		for (const special_uniform_update &update : effect.special_uniforms)
+		{
+			uniform &variable = effect.uniforms[update.uniform_index];
+
+			switch (update.source)
 			{
 				case special_uniform::frame_time:
 				{
-					set_uniform_value(variable, _last_frame_duration.count() * 1e-6f);
+					set_uniform_value(variable, frame_time);
 					break;
 				}
 				case special_uniform::frame_count:
@@ -2889,19 +3943,19 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 				}
 				case special_uniform::random:
 				{
-					const int min = variable.annotation_as_int("min", 0, 0);
-					const int max = variable.annotation_as_int("max", 0, RAND_MAX);
+					const int min = update.int_range[0];
+					const int max = update.int_range[1];
 					set_uniform_value(variable, min + (std::rand() % (std::abs(max - min) + 1)));
 					break;
 				}
 				case special_uniform::ping_pong:
 				{
-					const float min = variable.annotation_as_float("min", 0, 0.0f);
-					const float max = variable.annotation_as_float("max", 0, 1.0f);
-					const float step_min = variable.annotation_as_float("step", 0);
-					const float step_max = variable.annotation_as_float("step", 1);
+					const float min = update.range[0];
+					const float max = update.range[1];
+					const float step_min = update.step[0];
+					const float step_max = update.step[1];
 					float increment = step_max == 0 ? step_min : (step_min + std::fmodf(static_cast<float>(std::rand()), step_max - step_min + 1));
-					const float smoothing = variable.annotation_as_float("smoothing");
+					const float smoothing = update.smoothing;
 
 					float value[2] = { 0, 0 };
 					get_uniform_value(variable, value, 2);
@@ -2926,56 +3980,33 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 				}
 				case special_uniform::date:
 				{
-					const std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-					tm tm; localtime_s(&tm, &t);
-
-					const int value[4] = {
-						tm.tm_year + 1900,
-						tm.tm_mon + 1,
-						tm.tm_mday,
-						tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec
-					};
-					set_uniform_value(variable, value, 4);
+					update_date();
+					set_uniform_value(variable, date, 4);
 					break;
 				}
 				case special_uniform::timer:
 				{
-					const unsigned long long timer_ms = std::chrono::duration_cast<std::chrono::milliseconds>(_last_present_time - _start_time).count();
-					set_uniform_value(variable, static_cast<unsigned int>(timer_ms));
+					set_uniform_value(variable, timer_ms);
 					break;
 				}
 				case special_uniform::key:
 				{
-					if (const int keycode = variable.annotation_as_int("keycode");
-						keycode > 7 && keycode < 256)
+					if (update.mode == special_uniform_update::key_mode::toggle)
 					{
-						if (const std::string_view mode = variable.annotation_as_string("mode");
-							mode == "toggle" || variable.annotation_as_int("toggle"))
-						{
-							bool current_value = false;
-							get_uniform_value(variable, &current_value, 1);
-							if (_input->is_key_pressed(keycode))
-								set_uniform_value(variable, !current_value);
-						}
-						else if (mode == "press")
-							set_uniform_value(variable, _input->is_key_pressed(keycode));
-						else
-							set_uniform_value(variable, _input->is_key_down(keycode));
+						bool current_value = false;
+						get_uniform_value(variable, &current_value, 1);
+						if (_input->is_key_pressed(update.index))
+							set_uniform_value(variable, !current_value);
 					}
+					else if (update.mode == special_uniform_update::key_mode::press)
+						set_uniform_value(variable, _input->is_key_pressed(update.index));
+					else
+						set_uniform_value(variable, _input->is_key_down(update.index));
 					break;
 				}
 				case special_uniform::mouse_point:
 				{
-					uint32_t pos_x = _input->mouse_position_x();
-					uint32_t pos_y = _input->mouse_position_y();
-#if RESHADE_GUI
-					if (pos_x > _window_width)
-						pos_x = _window_width;
-					if (pos_y > _window_height)
-						pos_y = _window_height;
-#endif
-
-					set_uniform_value(variable, pos_x, pos_y);
+					set_uniform_value(variable, mouse_pos_x, mouse_pos_y);
 					break;
 				}
 				case special_uniform::mouse_delta:
@@ -2985,36 +4016,28 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 				}
 				case special_uniform::mouse_button:
 				{
-					if (const int keycode = variable.annotation_as_int("keycode");
-						keycode >= 0 && keycode < 5)
+					if (update.mode == special_uniform_update::key_mode::toggle)
 					{
-						if (const std::string_view mode = variable.annotation_as_string("mode");
-							mode == "toggle" || variable.annotation_as_int("toggle"))
-						{
-							bool current_value = false;
-							get_uniform_value(variable, &current_value, 1);
-							if (_input->is_mouse_button_pressed(keycode))
-								set_uniform_value(variable, !current_value);
-						}
-						else if (mode == "press")
-							set_uniform_value(variable, _input->is_mouse_button_pressed(keycode));
-						else
-							set_uniform_value(variable, _input->is_mouse_button_down(keycode));
+						bool current_value = false;
+						get_uniform_value(variable, &current_value, 1);
+						if (_input->is_mouse_button_pressed(update.index))
+							set_uniform_value(variable, !current_value);
 					}
+					else if (update.mode == special_uniform_update::key_mode::press)
+						set_uniform_value(variable, _input->is_mouse_button_pressed(update.index));
+					else
+						set_uniform_value(variable, _input->is_mouse_button_down(update.index));
 					break;
 				}
 				case special_uniform::mouse_wheel:
 				{
-					const float min = variable.annotation_as_float("min");
-					const float max = variable.annotation_as_float("max");
-					float step = variable.annotation_as_float("step");
-					if (step == 0.0f)
-						step  = 1.0f;
+					const float min = update.range[0];
+					const float max = update.range[1];
 
 					float value[2] = { 0, 0 };
 					get_uniform_value(variable, value, 2);
 					value[1] = _input->mouse_wheel_delta();
-					value[0] = value[0] + value[1] * step;
+					value[0] = value[0] + value[1] * update.step[0];
 					if (min != max)
 					{
 						value[0] = std::max(value[0], min);
@@ -3026,10 +4049,20 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 				case special_uniform::freepie:
 				{
 					if (freepie_io_data data;
-						freepie_io_read(variable.annotation_as_int("index"), &data))
+						freepie_io_read(update.index, &data))
 						set_uniform_value(variable, &data.yaw, 3 * 2);
 					break;
 				}
+				case special_uniform::render_scale:
+				{
+					set_uniform_value(variable, effect.render_scale);
+					break;
+				}
+				case special_uniform::phase:
+				{
+					set_uniform_value(variable, effect.phase, 2);
+					break;
+				}
 #if RESHADE_GUI
 				case special_uniform::overlay_open:
 				{
@@ -3083,10 +4116,24 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 	invoke_addon_event<addon_event::reshade_begin_effects>(this, cmd_list);
 #endif
 
+	// The application rendered a new frame since the back buffer was last copied
+	_backbuffer_texture_current = false;
+
+#if RESHADE_GUI
+	if (_gather_gpu_statistics || _record_gpu_timings)
+	{
+		_trace_frames.emplace_back();
+		while (_trace_frames.size() > _trace_frame_count)
+			_trace_frames.pop_front();
+	}
+#endif
+
+	const auto time_effects_started = std::chrono::high_resolution_clock::now();
+
 	// Render all enabled techniques
 	for (technique &tech : _techniques)
 	{
-		if (!_ignore_shortcuts && _input->is_key_pressed(tech.toggle_key_data, _force_shortcut_modifiers))
+		if (check_toggle_keys && _input->is_key_pressed(tech.toggle_key_data, _force_shortcut_modifiers))
 		{
 			if (!tech.enabled)
 				enable_technique(tech);
@@ -3094,7 +4141,7 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 				disable_technique(tech);
 		}
 
-		if (tech.passes_data.empty() || !tech.enabled)
+		if (tech.passes_data.empty() || tech.creating || !tech.enabled)
 			continue; // Ignore techniques that are not fully loaded or currently disabled
 
 		const auto time_technique_started = std::chrono::high_resolution_clock::now();
@@ -3103,6 +4150,13 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 
 		tech.average_cpu_duration.append(std::chrono::duration_cast<std::chrono::nanoseconds>(time_technique_finished - time_technique_started).count());
 
+#if RESHADE_GUI
+		if ((_gather_gpu_statistics || _record_gpu_timings) && !_trace_frames.empty())
+			_trace_frames.back().push_back({ tech.name,
+				static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time_technique_started - _start_time).count()),
+				static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time_technique_finished - time_technique_started).count()), false, false });
+#endif
+
 		if (tech.time_left > 0)
 		{
 			tech.time_left -= std::chrono::duration_cast<std::chrono::milliseconds>(_last_frame_duration).count();
@@ -3111,53 +4165,197 @@ void reshade::runtime::render_effects(api::command_list *cmd_list, api::resource
 		}
 	}
 
+	// Adjust render scales for the next frame based on the GPU timings read back above
+	if (_frame_budget > 0)
+	{
+		_frame_budget_entries.clear();
+		for (technique &tech : _techniques)
+			if (tech.enabled && !tech.passes_data.empty() && !tech.creating)
+				_frame_budget_entries.push_back(&tech.budget_state);
+
+		_frame_budget_controller.update(_frame_budget_entries.data(), _frame_budget_entries.size(), static_cast<uint64_t>(_frame_budget * 1e6f));
+	}
+
+	_effects_cpu_time_histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - time_effects_started).count());
+
 #if RESHADE_ADDON
 	invoke_addon_event<addon_event::reshade_finish_effects>(this, cmd_list);
 #endif
 }
+void reshade::runtime::update_frame_statistics()
+{
+	const uint64_t frame_time = std::chrono::duration_cast<std::chrono::nanoseconds>(_last_frame_duration).count();
+
+	// Compare against the typical frame time before adding this one, so that a spike cannot hide itself
+	if (const uint64_t median_frame_time = _frame_time_histogram.percentile(50);
+		_frame_time_histogram.count() >= 120 && frame_time > 2 * median_frame_time && frame_time > 4'000'000)
+	{
+		stutter_info &info = _stutters.emplace_back();
+		info.framecount = _framecount;
+		info.duration = _last_frame_duration;
+		info.median_duration = std::chrono::nanoseconds(median_frame_time);
+		info.reloading = is_loading() || !_reload_create_queue.empty();
+
+		// Effects that are still loading add techniques from other threads, so lock while taking the snapshot
+		const std::unique_lock<std::mutex> lock(_reload_mutex);
+
+		for (const technique &tech : _techniques)
+		{
+			if (tech.enabled)
+				info.enabled_techniques.push_back(tech.name);
+			if (tech.compiling || tech.creating || (tech.enabled && tech.passes_data.empty()))
+				info.loading_techniques.push_back(tech.name);
+		}
+
+		if (_stutters.size() > 32)
+			_stutters.pop_front();
+	}
+
+	_frame_time_histogram.record(frame_time);
+
+	// GPU times are only available while statistics are gathered (see 'render_technique')
+	if (_effects_gpu_duration != 0)
+		_effects_gpu_time_histogram.record(_effects_gpu_duration);
+	_effects_gpu_duration = 0;
+}
 void reshade::runtime::render_technique(api::command_list *cmd_list, technique &tech, api::resource backbuffer)
 {
-	const effect &effect = _effects[tech.effect_index];
+	effect &effect = _effects[tech.effect_index];
+
+	const uint32_t num_queries = static_cast<uint32_t>(tech.passes.size() + 1);
+	const uint32_t query_index = tech.query_base_index + static_cast<uint32_t>(_framecount % 4) * num_queries;
 
+	// The frame budget needs GPU timings even when statistics are not shown
 #if RESHADE_GUI
-	if (_gather_gpu_statistics)
+	const bool gather_gpu_timings = _gather_gpu_statistics || _record_gpu_timings || _frame_budget > 0;
+#else
+	const bool gather_gpu_timings = _frame_budget > 0;
+#endif
+
+	if (gather_gpu_timings)
 	{
+		const auto timestamps = static_cast<uint64_t *>(_malloca(num_queries * sizeof(uint64_t)));
+
 		// Evaluate queries from oldest frame in queue
-		if (uint64_t timestamps[2];
-			_device->get_query_pool_results(effect.query_heap, tech.query_base_index + ((_framecount + 1) % 4) * 2, 2, timestamps, sizeof(uint64_t)))
-			tech.average_gpu_duration.append(timestamps[1] - timestamps[0]);
+		if (_device->get_query_pool_results(effect.query_heap, tech.query_base_index + static_cast<uint32_t>((_framecount + 1) % 4) * num_queries, num_queries, timestamps, sizeof(uint64_t)))
+		{
+			// Convert to nanoseconds, so that everything below (statistics, trace and frame budget) works with the same unit on all APIs
+			if (_timestamp_period != 1.0)
+				for (uint32_t i = 0; i < num_queries; ++i)
+					timestamps[i] = static_cast<uint64_t>(timestamps[i] * _timestamp_period);
 
-		cmd_list->finish_query(effect.query_heap, api::query_type::timestamp, tech.query_base_index + (_framecount % 4) * 2);
-	}
+			tech.budget_state.record(timestamps[num_queries - 1] - timestamps[0]);
+			_effects_gpu_duration += timestamps[num_queries - 1] - timestamps[0];
+#if RESHADE_GUI
+			tech.average_gpu_duration.append(timestamps[num_queries - 1] - timestamps[0]);
+
+			if (!_trace_frames.empty())
+				_trace_frames.back().push_back({ tech.name, timestamps[0], timestamps[num_queries - 1] - timestamps[0], true, false });
+
+			for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
+			{
+				tech.passes_data[pass_index].average_gpu_duration.append(timestamps[pass_index + 1] - timestamps[pass_index]);
+
+				if (!_trace_frames.empty())
+					_trace_frames.back().push_back({ tech.passes[pass_index].name.empty() ? "Pass " + std::to_string(pass_index) : tech.passes[pass_index].name, timestamps[pass_index], timestamps[pass_index + 1] - timestamps[pass_index], true, true });
+			}
 #endif
+		}
+
+		_freea(timestamps);
+
+		cmd_list->finish_query(effect.query_heap, api::query_type::timestamp, query_index);
+	}
 
 #ifndef NDEBUG
 	const float debug_event_col[4] = { 1.0f, 0.8f, 0.8f, 1.0f };
 	cmd_list->begin_debug_event(tech.name.c_str(), debug_event_col);
 #endif
 
-	// Update shader constants
-	if (void *mapped_uniform_data; effect.cb != 0 &&
-		_device->map_buffer_region(effect.cb, 0, std::numeric_limits<uint64_t>::max(), api::map_access::write_discard, &mapped_uniform_data))
+	// Update shader constants, which only has to happen once per frame for all techniques of an effect and only if any uniform values were modified
+	if (effect.cb != 0 && effect.uniform_data_dirty_begin < effect.uniform_data_dirty_end)
 	{
-		std::memcpy(mapped_uniform_data, effect.uniform_data_storage.data(), effect.uniform_data_storage.size());
-		_device->unmap_buffer_region(effect.cb);
+		const size_t dirty_begin = effect.uniform_data_dirty_begin;
+		const size_t dirty_end = std::min(effect.uniform_data_dirty_end, effect.uniform_data_storage.size());
+
+		if (effect.cb_mapped != nullptr)
+		{
+			// Buffer is persistently mapped, so can write just the modified range
+			std::memcpy(static_cast<uint8_t *>(effect.cb_mapped) + dirty_begin, effect.uniform_data_storage.data() + dirty_begin, dirty_end - dirty_begin);
+		}
+		else if (void *mapped_uniform_data;
+			_device->map_buffer_region(effect.cb, 0, std::numeric_limits<uint64_t>::max(), api::map_access::write_discard, &mapped_uniform_data))
+		{
+			// Discarding the buffer loses its previous contents, so have to write everything
+			std::memcpy(mapped_uniform_data, effect.uniform_data_storage.data(), effect.uniform_data_storage.size());
+			_device->unmap_buffer_region(effect.cb);
+		}
+
+		effect.uniform_data_dirty_begin = std::numeric_limits<size_t>::max();
+		effect.uniform_data_dirty_end = 0;
 	}
 	else if (_renderer_id == 0x9000)
 	{
+		// Constants are global device state in D3D9 and other effects may have overwritten them since, so always have to set them again
 		cmd_list->push_constants(api::shader_stage::all, effect.layout, 0, 0, static_cast<uint32_t>(effect.uniform_data_storage.size() / sizeof(uint32_t)), reinterpret_cast<const uint32_t *>(effect.uniform_data_storage.data()));
 	}
 
 	const bool sampler_with_resource_view = _device->check_capability(api::device_caps::sampler_with_resource_view);
 
 	bool is_effect_stencil_cleared = false;
-	bool needs_implicit_backbuffer_copy = true; // First pass always needs the back buffer updated
+
+	const auto submit_barriers = [this, cmd_list](const technique::barrier_list &barriers) {
+		if (barriers.resources.empty())
+			return;
+		const uint32_t num_barriers = static_cast<uint32_t>(barriers.resources.size());
+		cmd_list->barrier(num_barriers, barriers.resources.data(), barriers.state_old.data(), barriers.state_new.data());
+		_barrier_count += num_barriers;
+	};
+
+	// The effect-wide descriptor sets stay bound between passes, since all of them use the same pipeline layout
+	// Other effects or the application may have changed bindings in between techniques though, so always bind them once at the start
+	bool effect_sets_bound[2] = { false, false };
+	const auto bind_effect_sets = [&](api::shader_stage stages, int stage_index) {
+		if (effect_sets_bound[stage_index])
+			return;
+		effect_sets_bound[stage_index] = true;
+
+		if (effect.cb_set != 0 && effect.sampler_set != 0)
+		{
+			assert(!sampler_with_resource_view);
+			const api::descriptor_set effect_sets[2] = { effect.cb_set, effect.sampler_set };
+			cmd_list->bind_descriptor_sets(stages, effect.layout, 0, 2, effect_sets);
+		}
+		else if (effect.cb_set != 0)
+			cmd_list->bind_descriptor_set(stages, effect.layout, 0, effect.cb_set);
+		else if (effect.sampler_set != 0)
+			assert(!sampler_with_resource_view),
+			cmd_list->bind_descriptor_set(stages, effect.layout, 1, effect.sampler_set);
+	};
+
+	const uint32_t phase = tech.current_phase(_framecount);
+	const uint32_t interleave_band = phase / tech.update_interval;
+	const bool update_intermediate_passes = (phase % tech.update_interval) == 0;
 
 	for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
 	{
-		if (needs_implicit_backbuffer_copy)
+		const reshadefx::pass_info &pass_info = tech.passes[pass_index];
+		const technique::pass_data &pass_data = tech.passes_data[pass_index];
+
+		// Passes writing to the back buffer always run, so that they can reuse the results of the intermediate passes from the last update
+		if (!update_intermediate_passes && (!pass_info.cs_entry_point.empty() || !pass_info.render_target_names[0].empty()))
+		{
+			// Still write the timestamp, so that the query results of this frame are complete
+			if (gather_gpu_timings)
+				cmd_list->finish_query(effect.query_heap, api::query_type::timestamp, query_index + static_cast<uint32_t>(pass_index) + 1);
+			continue;
+		}
+
+		// Copy the back buffer only right before it is actually sampled and only if it was written to since the last copy (which may have happened in a previous technique already)
+		if (pass_data.reads_backbuffer && !_backbuffer_texture_current)
 		{
-			// Save back buffer of previous pass
+			_backbuffer_texture_current = true;
+
 			const api::resource resources[2] = { backbuffer, _backbuffer_texture };
 			const api::resource_usage state_old[2] = { api::resource_usage::render_target, api::resource_usage::shader_resource };
 			const api::resource_usage state_new[2] = { api::resource_usage::copy_source, api::resource_usage::copy_dest };
@@ -3165,56 +4363,47 @@ void reshade::runtime::render_technique(api::command_list *cmd_list, technique &
 			cmd_list->barrier(2, resources, state_old, state_new);
 			cmd_list->copy_resource(backbuffer, _backbuffer_texture);
 			cmd_list->barrier(2, resources, state_new, state_old);
+			_barrier_count += 4;
 		}
 
-		const reshadefx::pass_info &pass_info = tech.passes[pass_index];
-		const technique::pass_data &pass_data = tech.passes_data[pass_index];
-
 #ifndef NDEBUG
 		cmd_list->begin_debug_event((pass_info.name.empty() ? "Pass " + std::to_string(pass_index) : pass_info.name).c_str(), debug_event_col);
 #endif
 
-		const uint32_t num_barriers = static_cast<uint32_t>(pass_data.modified_resources.size());
-
 		if (!pass_info.cs_entry_point.empty())
 		{
-			// Compute shaders do not write to the back buffer, so no update necessary
-			needs_implicit_backbuffer_copy = false;
-
+			// Compute shaders do not write to the back buffer, so the copy of it stays current
 			cmd_list->bind_pipeline(api::pipeline_stage::all_compute, pass_data.pipeline);
 
-			std::vector<api::resource_usage> state_old(num_barriers, api::resource_usage::shader_resource);
-			std::vector<api::resource_usage> state_new(num_barriers, api::resource_usage::unordered_access);
-			cmd_list->barrier(num_barriers, pass_data.modified_resources.data(), state_old.data(), state_new.data());
+			submit_barriers(pass_data.barriers_before);
 
-			// Reset bindings on every pass (since they get invalidated by the call to 'generate_mipmaps' below)
-			if (effect.cb != 0)
-				cmd_list->bind_descriptor_set(api::shader_stage::all_compute, effect.layout, 0, effect.cb_set);
-			if (effect.sampler_set != 0)
-				assert(!sampler_with_resource_view),
-				cmd_list->bind_descriptor_set(api::shader_stage::all_compute, effect.layout, 1, effect.sampler_set);
-			if (pass_data.texture_set != 0)
+			bind_effect_sets(api::shader_stage::all_compute, 1);
+			if (pass_data.texture_set != 0 && pass_data.storage_set != 0)
+			{
+				const api::descriptor_set pass_sets[2] = { pass_data.texture_set, pass_data.storage_set };
+				cmd_list->bind_descriptor_sets(api::shader_stage::all_compute, effect.layout, sampler_with_resource_view ? 1 : 2, 2, pass_sets);
+			}
+			else if (pass_data.texture_set != 0)
 				cmd_list->bind_descriptor_set(api::shader_stage::all_compute, effect.layout, sampler_with_resource_view ? 1 : 2, pass_data.texture_set);
-			if (pass_data.storage_set != 0)
+			else if (pass_data.storage_set != 0)
 				cmd_list->bind_descriptor_set(api::shader_stage::all_compute, effect.layout, sampler_with_resource_view ? 2 : 3, pass_data.storage_set);
 
 			cmd_list->dispatch(pass_info.viewport_width, pass_info.viewport_height, pass_info.viewport_dispatch_z);
 
-			cmd_list->barrier(num_barriers, pass_data.modified_resources.data(), state_new.data(), state_old.data());
+			submit_barriers(pass_data.barriers_after);
 		}
 		else
 		{
 			cmd_list->bind_pipeline(api::pipeline_stage::all_graphics, pass_data.pipeline);
 
 			// Transition resource state for render targets
-			std::vector<api::resource_usage> state_old(num_barriers, api::resource_usage::shader_resource);
-			std::vector<api::resource_usage> state_new(num_barriers, api::resource_usage::render_target);
-			cmd_list->barrier(num_barriers, pass_data.modified_resources.data(), state_old.data(), state_new.data());
+			submit_barriers(pass_data.barriers_before);
 
 			// Setup render targets
 			if (pass_info.render_target_names[0].empty())
 			{
-				needs_implicit_backbuffer_copy = true;
+				// This pass writes to the back buffer, so the copy of it is outdated afterwards
+				_backbuffer_texture_current = false;
 
 				uint32_t index = get_current_back_buffer_index();
 				index = (index * 2) + pass_info.srgb_write_enable;
@@ -3222,15 +4411,42 @@ void reshade::runtime::render_technique(api::command_list *cmd_list, technique &
 			}
 			else
 			{
-				needs_implicit_backbuffer_copy = false;
-
 				cmd_list->begin_render_pass(pass_data.pass, pass_data.fbo);
 			}
 
+			// Passes of scalable techniques that write to intermediate textures only render to the top-left part of them when over the frame budget
+			// The effect is responsible for taking that into account when sampling those textures again (through a uniform with the "render_scale" source)
+			// Fixed-size render targets (like look-up tables) are never scaled, since their contents do not depend on the screen resolution
+			uint32_t viewport_width = pass_info.viewport_width;
+			uint32_t viewport_height = pass_info.viewport_height;
+			if (_frame_budget > 0 && tech.budget_state.scale < 1.0f && !pass_info.render_target_names[0].empty() &&
+				is_back_buffer_relative_size(viewport_width, viewport_height, _width, _height))
+			{
+				viewport_width = std::max(1u, static_cast<uint32_t>(viewport_width * tech.budget_state.scale + 0.5f));
+				viewport_height = std::max(1u, static_cast<uint32_t>(viewport_height * tech.budget_state.scale + 0.5f));
+			}
+
+			int32_t scissor_rect[4] = {
+				0, 0,
+				static_cast<int32_t>(viewport_width),
+				static_cast<int32_t>(viewport_height)
+			};
+			// Only update one horizontal band of intermediate render targets per frame when interleaving
+			if (tech.interleave > 1 && !pass_info.render_target_names[0].empty())
+			{
+				const uint32_t band_height = (viewport_height + tech.interleave - 1) / tech.interleave;
+				scissor_rect[1] = static_cast<int32_t>(std::min(viewport_height, interleave_band * band_height));
+				scissor_rect[3] = static_cast<int32_t>(std::min(viewport_height, (interleave_band + 1) * band_height));
+			}
+
 			if (pass_info.clear_render_targets)
 			{
 				constexpr float clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-				cmd_list->clear_attachments(api::attachment_type::color, clear_color, 0, 0);
+				// Clearing ignores the scissor rectangle, so restrict it to the current band explicitly to keep the other interleave bands intact
+				if (tech.interleave > 1 && !pass_info.render_target_names[0].empty())
+					cmd_list->clear_attachments(api::attachment_type::color, clear_color, 0, 0, 1, scissor_rect);
+				else
+					cmd_list->clear_attachments(api::attachment_type::color, clear_color, 0, 0);
 			}
 
 			// First pass to use the stencil buffer should clear it
@@ -3241,36 +4457,26 @@ void reshade::runtime::render_technique(api::command_list *cmd_list, technique &
 				cmd_list->clear_attachments(api::attachment_type::stencil, nullptr, 1.0f, 0x0);
 			}
 
-			// Reset bindings on every pass (since they get invalidated by the call to 'generate_mipmaps' below)
-			if (effect.cb != 0)
-				cmd_list->bind_descriptor_set(api::shader_stage::all_graphics, effect.layout, 0, effect.cb_set);
-			if (effect.sampler_set != 0)
-				assert(!sampler_with_resource_view),
-				cmd_list->bind_descriptor_set(api::shader_stage::all_graphics, effect.layout, 1, effect.sampler_set);
+			bind_effect_sets(api::shader_stage::all_graphics, 0);
 			// Setup shader resources after binding render targets, to ensure any OM bindings by the application are unset at this point (e.g. a depth buffer that was bound to the OM and is now bound as shader resource)
 			if (pass_data.texture_set != 0)
 				cmd_list->bind_descriptor_set(api::shader_stage::all_graphics, effect.layout, sampler_with_resource_view ? 1 : 2, pass_data.texture_set);
 
 			const float viewport[6] = {
 				0.0f, 0.0f,
-				static_cast<float>(pass_info.viewport_width),
-				static_cast<float>(pass_info.viewport_height),
+				static_cast<float>(viewport_width),
+				static_cast<float>(viewport_height),
 				0.0f, 1.0f
 			};
 			cmd_list->bind_viewports(0, 1, viewport);
-			const int32_t scissor_rect[4] = {
-				0, 0,
-				static_cast<int32_t>(pass_info.viewport_width),
-				static_cast<int32_t>(pass_info.viewport_height)
-			};
 			cmd_list->bind_scissor_rects(0, 1, scissor_rect);
 
 			if (_renderer_id == 0x9000)
 			{
 				// Set __TEXEL_SIZE__ constant (see effect_codegen_hlsl.cpp)
 				const float texel_size[4] = {
-					-1.0f / pass_info.viewport_width,
-					 1.0f / pass_info.viewport_height
+					-1.0f / viewport_width,
+					 1.0f / viewport_height
 				};
 				cmd_list->push_constants(api::shader_stage::vertex, effect.layout, 0, 255 * 4, 4, texel_size);
 			}
@@ -3281,12 +4487,18 @@ void reshade::runtime::render_technique(api::command_list *cmd_list, technique &
 			cmd_list->finish_render_pass();
 
 			// Transition resource state back to shader access
-			cmd_list->barrier(num_barriers, pass_data.modified_resources.data(), state_new.data(), state_old.data());
+			submit_barriers(pass_data.barriers_after);
 		}
 
 		// Generate mipmaps for modified resources
 		for (const api::resource_view modified_texture : pass_data.generate_mipmap_views)
 			cmd_list->generate_mipmaps(modified_texture);
+		// This invalidates all descriptor bindings, so have to set them again in the next pass
+		if (!pass_data.generate_mipmap_views.empty())
+			effect_sets_bound[0] = effect_sets_bound[1] = false;
+
+		if (gather_gpu_timings)
+			cmd_list->finish_query(effect.query_heap, api::query_type::timestamp, query_index + static_cast<uint32_t>(pass_index) + 1);
 
 #ifndef NDEBUG
 		cmd_list->finish_debug_event();
@@ -3297,10 +4509,6 @@ void reshade::runtime::render_technique(api::command_list *cmd_list, technique &
 	cmd_list->finish_debug_event();
 #endif
 
-#if RESHADE_GUI
-	if (_gather_gpu_statistics)
-		cmd_list->finish_query(effect.query_heap, api::query_type::timestamp, tech.query_base_index + (_framecount % 4) * 2 + 1);
-#endif
 }
 
 void reshade::runtime::save_texture(const texture &tex)
@@ -3345,6 +4553,88 @@ void reshade::runtime::save_texture(const texture &tex)
 	_last_screenshot_file = screenshot_path;
 	_last_screenshot_time = std::chrono::high_resolution_clock::now();
 }
+#if RESHADE_GUI
+void reshade::runtime::save_trace() const
+{
+	char timestamp[21];
+	const std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	tm tm; localtime_s(&tm, &t);
+	sprintf_s(timestamp, " %.4d-%.2d-%.2d %.2d-%.2d-%.2d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+
+	const std::filesystem::path trace_path = g_reshade_base_path / std::filesystem::u8path(std::string("ReShade Trace") + timestamp + ".json");
+
+	const std::string json = get_trace_json();
+
+	if (FILE *file; _wfopen_s(&file, trace_path.c_str(), L"wb") == 0)
+	{
+		fwrite(json.data(), 1, json.size(), file);
+		fclose(file);
+
+		LOG(INFO) << "Saved timings of the last " << _trace_frames.size() << " frames to " << trace_path << '.';
+	}
+	else
+	{
+		LOG(ERROR) << "Failed to open " << trace_path << " for writing!";
+	}
+}
+
+std::vector<std::pair<std::string, uint64_t>> reshade::runtime::get_pass_gpu_durations() const
+{
+	std::vector<std::pair<std::string, uint64_t>> durations;
+
+	for (const technique &tech : _techniques)
+	{
+		if (tech.passes_data.empty() || !tech.enabled)
+			continue;
+
+		for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
+			durations.emplace_back(tech.passes[pass_index].name.empty() ? "Pass " + std::to_string(pass_index) : tech.passes[pass_index].name, tech.passes_data[pass_index].average_gpu_duration);
+	}
+
+	return durations;
+}
+
+std::string reshade::runtime::get_trace_json() const
+{
+	// GPU timestamps are not related to the CPU clock, so shift them to start at zero
+	uint64_t gpu_base = std::numeric_limits<uint64_t>::max();
+	for (const std::vector<trace_event> &frame : _trace_frames)
+		for (const trace_event &event : frame)
+			if (event.gpu)
+				gpu_base = std::min(gpu_base, event.start);
+
+	// Write timings in the Chrome trace event format (see https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU)
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+	for (const std::vector<trace_event> &frame : _trace_frames)
+	{
+		for (const trace_event &event : frame)
+		{
+			std::string name;
+			for (const char c : event.name)
+				if (c == '\"' || c == '\\')
+					name += '\\', name += c;
+				else if (static_cast<unsigned char>(c) >= 0x20)
+					name += c;
+
+			char buf[128];
+			sprintf_s(buf, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":1}",
+				event.pass ? "pass" : "technique",
+				(event.start - (event.gpu ? gpu_base : 0)) * 1e-3,
+				event.duration * 1e-3,
+				event.gpu ? 2 : 1);
+
+			json += ",\n{\"name\":\"" + name + buf;
+		}
+	}
+
+	json += "\n]}\n";
+
+	return json;
+}
+#endif
 void reshade::runtime::save_screenshot(const std::wstring &postfix, const bool should_save_preset)
 {
 	char timestamp[21];
@@ -3423,9 +4713,16 @@ void reshade::runtime::save_screenshot(const std::wstring &postfix, const bool s
 
 void reshade::runtime::reset_uniform_value(uniform &variable)
 {
+	// Values in the shared constant buffer are always overwritten in 'render_effects', so there is nothing to reset
+	if (variable.in_shared_block)
+		return;
+
 	if (!variable.has_initializer_value)
 	{
-		std::memset(_effects[variable.effect_index].uniform_data_storage.data() + variable.offset, 0, variable.size);
+		effect &effect = _effects[variable.effect_index];
+		std::memset(effect.uniform_data_storage.data() + variable.offset, 0, variable.size);
+		effect.uniform_data_dirty_begin = std::min(effect.uniform_data_dirty_begin, static_cast<size_t>(variable.offset));
+		effect.uniform_data_dirty_end = std::max(effect.uniform_data_dirty_end, static_cast<size_t>(variable.offset + variable.size));
 		return;
 	}
 
@@ -3497,10 +4794,13 @@ void reshade::runtime::get_uniform_binding(api::effect_uniform_variable variable
 	if (variable == 0)
 		return;
 
+	const uniform &variable_info = *reinterpret_cast<const uniform *>(variable.handle);
+
+	// Uniforms in the shared block live in the constant buffer that is shared between all effects, at the offset of their slot
 	if (out_buffer != nullptr)
-		*out_buffer = _effects[reinterpret_cast<const uniform *>(variable.handle)->effect_index].cb;
+		*out_buffer = variable_info.in_shared_block ? _shared_cb : _effects[variable_info.effect_index].cb;
 	if (out_offset != nullptr)
-		*out_offset = reinterpret_cast<const uniform *>(variable.handle)->offset;
+		*out_offset = variable_info.offset;
 }
 
 void reshade::runtime::get_uniform_annotation(api::effect_uniform_variable variable, const char *name, bool *values, size_t count, size_t array_index) const
@@ -3566,8 +4866,8 @@ void reshade::runtime::get_uniform_data(const uniform &variable, uint8_t *data,
 	size = std::min(size, static_cast<size_t>(variable.size));
 	assert(data != nullptr && (size % 4) == 0);
 
-	auto &data_storage = _effects[variable.effect_index].uniform_data_storage;
-	assert(variable.offset + size <= data_storage.size());
+	const uint8_t *const data_storage = variable.in_shared_block ? reinterpret_cast<const uint8_t *>(&_shared_uniform_data) : _effects[variable.effect_index].uniform_data_storage.data();
+	assert(variable.offset + size <= (variable.in_shared_block ? sizeof(_shared_uniform_data) : _effects[variable.effect_index].uniform_data_storage.size()));
 
 	const size_t array_length = (variable.type.is_array() ? variable.type.array_length : 1);
 	if (assert(base_index < array_length); base_index >= array_length)
@@ -3581,7 +4881,7 @@ void reshade::runtime::get_uniform_data(const uniform &variable, uint8_t *data,
 				for (size_t col = 0; i < (size / 4) && col < variable.type.cols; ++col, ++i)
 					std::memcpy(
 						data + ((a - base_index) * variable.type.components() + (row * variable.type.cols + col)) * 4,
-						data_storage.data() + variable.offset + (a * (variable.type.rows * 4) + (row * 4 + col)) * 4, 4);
+						data_storage + variable.offset + (a * (variable.type.rows * 4) + (row * 4 + col)) * 4, 4);
 	}
 	else if (array_length > 1)
 	{
@@ -3590,11 +4890,11 @@ void reshade::runtime::get_uniform_data(const uniform &variable, uint8_t *data,
 			for (size_t row = 0; i < (size / 4) && row < variable.type.rows; ++row, ++i)
 				std::memcpy(
 					data + ((a - base_index) * variable.type.components() + row) * 4,
-					data_storage.data() + variable.offset + (a * 4 + row) * 4, 4);
+					data_storage + variable.offset + (a * 4 + row) * 4, 4);
 	}
 	else
 	{
-		std::memcpy(data, data_storage.data() + variable.offset, size);
+		std::memcpy(data, data_storage + variable.offset, size);
 	}
 }
 void reshade::runtime::get_uniform_data(api::effect_uniform_variable handle, bool *values, size_t count, size_t array_index) const
@@ -3667,13 +4967,22 @@ void reshade::runtime::set_uniform_data(uniform &variable, const uint8_t *data,
 	size = std::min(size, static_cast<size_t>(variable.size));
 	assert(data != nullptr && (size % 4) == 0);
 
-	auto &data_storage = _effects[variable.effect_index].uniform_data_storage;
-	assert(variable.offset + size <= data_storage.size());
+	uint8_t *const data_storage = variable.in_shared_block ? reinterpret_cast<uint8_t *>(&_shared_uniform_data) : _effects[variable.effect_index].uniform_data_storage.data();
+	assert(variable.offset + size <= (variable.in_shared_block ? sizeof(_shared_uniform_data) : _effects[variable.effect_index].uniform_data_storage.size()));
 
 	const size_t array_length = (variable.type.is_array() ? variable.type.array_length : 1);
 	if (assert(base_index < array_length); base_index >= array_length)
 		return;
 
+	// Keep track of the modified range, so that only that has to be uploaded (see 'render_technique')
+	// The shared constant buffer is uploaded every frame anyway, so does not need this
+	if (!variable.in_shared_block)
+	{
+		effect &effect = _effects[variable.effect_index];
+		effect.uniform_data_dirty_begin = std::min(effect.uniform_data_dirty_begin, static_cast<size_t>(variable.offset));
+		effect.uniform_data_dirty_end = std::max(effect.uniform_data_dirty_end, static_cast<size_t>(variable.offset + variable.size));
+	}
+
 	if (variable.type.is_matrix())
 	{
 		for (size_t a = base_index, i = 0; a < array_length; ++a)
@@ -3681,7 +4990,7 @@ void reshade::runtime::set_uniform_data(uniform &variable, const uint8_t *data,
 			for (size_t row = 0; row < variable.type.rows; ++row)
 				for (size_t col = 0; i < (size / 4) && col < variable.type.cols; ++col, ++i)
 					std::memcpy(
-						data_storage.data() + variable.offset + (a * variable.type.rows * 4 + (row * 4 + col)) * 4,
+						data_storage + variable.offset + (a * variable.type.rows * 4 + (row * 4 + col)) * 4,
 						data + ((a - base_index) * variable.type.components() + (row * variable.type.cols + col)) * 4, 4);
 	}
 	else if (array_length > 1)
@@ -3690,12 +4999,12 @@ void reshade::runtime::set_uniform_data(uniform &variable, const uint8_t *data,
 			// Each element in the array is 16-byte aligned, so needs special handling
 			for (size_t row = 0; i < (size / 4) && row < variable.type.rows; ++row, ++i)
 				std::memcpy(
-					data_storage.data() + variable.offset + (a * 4 + row) * 4,
+					data_storage + variable.offset + (a * 4 + row) * 4,
 					data + ((a - base_index) * variable.type.components() + row) * 4, 4);
 	}
 	else
 	{
-		std::memcpy(data_storage.data() + variable.offset, data, size);
+		std::memcpy(data_storage + variable.offset, data, size);
 	}
 }
 void reshade::runtime::set_uniform_data(api::effect_uniform_variable handle, const bool *values, size_t count, size_t array_index)
@@ -6,6 +6,8 @@
 #pragma once
 
 #include "reshade_api.hpp"
+#include "frame_budget.hpp"
+#include "log_histogram.hpp"
 #if RESHADE_GUI
 #include "imgui_code_editor.hpp"
 
@@ -13,6 +15,7 @@ struct ImDrawData;
 struct ImGuiContext;
 #endif
 
+#include <list>
 #include <mutex>
 #include <memory>
 #include <atomic>
@@ -29,6 +32,22 @@ namespace reshade
 	struct uniform;
 	struct texture;
 	struct technique;
+	struct compiled_technique;
+	struct created_pipelines;
+
+	// Layout of the shared constant buffer, which has to match the slots in 'reshadefx::shared_uniform_slots'
+	struct shared_uniform_data
+	{
+		float frame_time;
+		float timer;
+		int32_t frame_count_int;
+		uint32_t frame_count_uint;
+		float date_float[4];
+		int32_t date_int[4];
+		float mouse_point[2];
+		uint32_t overlay_open;
+		uint32_t padding;
+	};
 
 	/// <summary>
 	/// The main ReShade post-processing effect runtime.
@@ -53,6 +72,21 @@ namespace reshade
 
 		virtual void render_effects(api::command_list *cmd_list, api::resource_view rtv, api::resource_view rtv_srgb) override;
 
+#if RESHADE_GUI
+		/// <summary>
+		/// Keeps recording GPU timings of all techniques and passes into the trace, even while no statistics are shown in the overlay.
+		/// </summary>
+		void set_record_gpu_timings(bool enabled) { _record_gpu_timings = enabled; }
+		/// <summary>
+		/// Gets the average GPU duration in nanoseconds of every pass of all enabled techniques, named like in the trace.
+		/// </summary>
+		std::vector<std::pair<std::string, uint64_t>> get_pass_gpu_durations() const;
+		/// <summary>
+		/// Gets the timings recorded for the last frames in the Chrome trace event format.
+		/// </summary>
+		std::string get_trace_json() const;
+#endif
+
 		/// <summary>
 		/// Captures a screenshot of the current back buffer resource and writes it to an image file on disk.
 		/// </summary>
@@ -149,6 +183,8 @@ namespace reshade
 		unsigned int _vendor_id = 0;
 		unsigned int _device_id = 0;
 		unsigned int _renderer_id = 0;
+		// Nanoseconds per tick of timestamp queries, which some APIs report in a device-specific frequency
+		double _timestamp_period = 1.0;
 		api::format  _backbuffer_format = api::format::unknown;
 		bool _is_vr = false;
 
@@ -165,18 +201,25 @@ namespace reshade
 
 		void enable_technique(technique &technique);
 		void disable_technique(technique &technique);
+		void compile_technique(technique &technique);
 
 		bool load_effect(const std::filesystem::path &source_file, const ini_file &preset, size_t effect_index, bool preprocess_required = false);
+		bool compile_effect_entry_point(const effect &effect, size_t entry_point_index, std::string &cso, std::string &cso_text, std::string &errors) const;
 		bool create_effect(size_t effect_index);
 		void destroy_effect(size_t effect_index);
+		void destroy_cached_pipelines(effect &effect);
+		void trim_effect_variant_cache(size_t max_size);
 
 		bool create_texture(texture &texture);
 		void destroy_texture(texture &texture);
+		void release_unused_textures();
 
 		void load_effects();
 		void load_textures();
+		bool load_texture(texture &texture);
 		bool reload_effect(size_t effect_index, bool preprocess_required = false);
 		void reload_effects();
+		void reload_modified_files(const std::vector<std::filesystem::path> &modified_files);
 		void destroy_effects();
 
 		bool load_effect_cache(const std::string &id, const std::string &type, std::string &data) const;
@@ -185,8 +228,12 @@ namespace reshade
 
 		void update_effects();
 		void render_technique(api::command_list *cmd_list, technique &technique, api::resource backbuffer);
+		void update_frame_statistics();
 
 		void save_texture(const texture &texture);
+#if RESHADE_GUI
+		void save_trace() const;
+#endif
 
 		void reset_uniform_value(uniform &variable);
 
@@ -221,16 +268,31 @@ namespace reshade
 		bool _no_reload_for_non_vr = false;
 		bool _performance_mode = false;
 		bool _effect_load_skipping = false;
+		bool _technique_compile_skipping = false;
+		bool _create_effects_in_background = false;
+		bool _reload_on_file_change = false;
+		bool _pool_transient_textures = false;
+		bool _lazy_texture_allocation = false;
+		unsigned int _texture_release_delay = 10;
+		std::chrono::high_resolution_clock::time_point _last_texture_release_check;
 		bool _load_option_disable_skipping = false;
 		std::atomic<int> _last_reload_successfull = true;
 		bool _last_texture_reload_successfull = true;
 		bool _textures_loaded = false;
 		unsigned int _reload_key_data[4];
 		unsigned int _performance_mode_key_data[4];
+		unsigned int _reload_create_budget = 2;
+		unsigned int _effect_variant_cache_size = 64;
+		std::list<effect> _effect_variant_cache;
 		std::vector<size_t> _reload_create_queue;
 		std::atomic<size_t> _reload_remaining_effects = 0;
+		std::atomic<size_t> _reload_remaining_techniques = 0;
+		std::vector<compiled_technique> _reload_compiled_techniques;
+		std::atomic<size_t> _reload_remaining_pipelines = 0;
+		std::vector<created_pipelines> _reload_created_pipelines;
 		std::mutex _reload_mutex;
 		std::vector<std::thread> _worker_threads;
+		std::shared_ptr<class file_watcher> _file_watcher;
 		std::vector<std::string> _global_preprocessor_definitions;
 		std::vector<std::string> _preset_preprocessor_definitions;
 		std::vector<std::filesystem::path> _effect_search_paths;
@@ -250,14 +312,42 @@ namespace reshade
 		std::vector<api::resource_view> _backbuffer_targets;
 		api::resource _backbuffer_texture = {};
 		api::resource_view _backbuffer_texture_view[2] = {};
+		bool _backbuffer_texture_current = false;
 		api::format _effect_stencil_format = api::format::unknown;
 		api::resource _effect_stencil = {};
 		api::resource_view _effect_stencil_target = {};
 		api::resource _empty_texture = {};
 		api::resource_view _empty_texture_view = {};
+		uint32_t _barrier_count = 0;
+		uint32_t _last_frame_barrier_count = 0;
+		api::resource _shared_cb = {};
+		shared_uniform_data _shared_uniform_data = {};
 		std::unordered_map<size_t, api::sampler> _effect_sampler_states;
 		std::unordered_map<std::string, std::pair<api::resource_view, api::resource_view>> _texture_semantic_bindings;
 		std::unordered_map<std::string, std::pair<api::resource_view, api::resource_view>> _backup_texture_semantic_bindings;
+		// GPU time budget for all effects in milliseconds, or zero to disable scaling of techniques
+		float _frame_budget = 0.0f;
+		frame_budget_controller _frame_budget_controller;
+		std::vector<frame_budget_controller::entry *> _frame_budget_entries;
+
+		// === Frame Statistics ===
+
+		struct stutter_info
+		{
+			uint64_t framecount;
+			std::chrono::high_resolution_clock::duration duration;
+			std::chrono::high_resolution_clock::duration median_duration;
+			std::vector<std::string> enabled_techniques;
+			std::vector<std::string> loading_techniques;
+			bool reloading;
+		};
+
+		log_histogram _frame_time_histogram;
+		log_histogram _effects_cpu_time_histogram;
+		log_histogram _effects_gpu_time_histogram;
+		uint64_t _effects_gpu_duration = 0;
+		// Most recent frames that took much longer than usual, together with what the runtime was doing at the time
+		std::list<stutter_info> _stutters;
 
 		// === Screenshots ===
 
@@ -350,6 +440,7 @@ namespace reshade
 		bool _no_font_scaling = false;
 		bool _rebuild_font_atlas = true;
 		bool _gather_gpu_statistics = false;
+		bool _record_gpu_timings = false;
 		unsigned int _reload_count = 0;
 		unsigned int _overlay_key_data[4];
 		int _fps_pos = 1;
@@ -392,6 +483,18 @@ namespace reshade
 		api::resource_view _preview_texture = { 0 };
 		unsigned int _preview_size[3] = { 0, 0, 0xFFFFFFFF };
 
+		struct trace_event
+		{
+			std::string name;
+			uint64_t start; // In nanoseconds, CPU events are relative to the start time, GPU events use raw timestamps
+			uint64_t duration;
+			bool gpu;
+			bool pass;
+		};
+		// Timings of the last frames while statistics are gathered, which can be exported as a trace (see 'save_trace')
+		std::list<std::vector<trace_event>> _trace_frames;
+		unsigned int _trace_frame_count = 300;
+
 		// === User Interface - Log ===
 
 		bool _log_wordwrap = false;
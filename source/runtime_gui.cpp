@@ -186,6 +186,7 @@ void reshade::runtime::load_config_gui(const ini_file &config)
 	config.get("OVERLAY", "ShowFPS", _show_fps);
 	config.get("OVERLAY", "ShowFrameTime", _show_frametime);
 	config.get("OVERLAY", "ShowScreenshotMessage", _show_screenshot_message);
+	config.get("OVERLAY", "TraceFrameCount", _trace_frame_count);
 	config.get("OVERLAY", "TutorialProgress", _tutorial_index);
 	config.get("OVERLAY", "VariableListHeight", _variable_editor_height);
 	config.get("OVERLAY", "VariableListUseTabs", _variable_editor_tabs);
@@ -233,6 +234,7 @@ void reshade::runtime::save_config_gui(ini_file &config) const
 	config.set("OVERLAY", "ShowFPS", _show_fps);
 	config.set("OVERLAY", "ShowFrameTime", _show_frametime);
 	config.set("OVERLAY", "ShowScreenshotMessage", _show_screenshot_message);
+	config.set("OVERLAY", "TraceFrameCount", _trace_frame_count);
 	config.set("OVERLAY", "TutorialProgress", _tutorial_index);
 	config.set("OVERLAY", "VariableListHeight", _variable_editor_height);
 	config.set("OVERLAY", "VariableListUseTabs", _variable_editor_tabs);
@@ -1398,6 +1400,38 @@ void reshade::runtime::draw_gui_settings()
 			reload_effects();
 		}
 
+		modified |= ImGui::Checkbox("Compile only enabled techniques", &_technique_compile_skipping);
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Disabled techniques are compiled in the background when they are enabled.\nThis can reduce loading times significantly when a lot of effects are installed.");
+
+		modified |= ImGui::Checkbox("Create effects in background", &_create_effects_in_background);
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Creates pipelines on worker threads to reduce stutter after loading (Direct3D 12 and Vulkan only).\nTechniques start rendering once all their pipelines were created.");
+
+		modified |= ImGui::Checkbox("Reload effects on file change", &_reload_on_file_change);
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Watches the effect and texture search paths and reloads only the effects and textures affected by a modified file.");
+
+		if (ImGui::Checkbox("Share intermediate render targets", &_pool_transient_textures))
+		{
+			modified = true;
+			reload_effects();
+		}
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Lets effects share render targets whose contents are only needed within a single technique, which reduces video memory usage.\nThis assumes that a full-screen pass overwrites every pixel, which is not the case for shaders that discard pixels, so some effects may show artifacts.");
+
+		if (ImGui::Checkbox("Allocate textures on demand", &_lazy_texture_allocation))
+		{
+			modified = true;
+			reload_effects();
+		}
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Creates the textures of a technique only once it is enabled and releases them again %u seconds after all techniques using them were disabled.\nEnabling a technique for the first time may cause a short stutter with this, and released textures lose their contents (e.g. history of temporal effects).", _texture_release_delay);
+
+		modified |= ImGui::SliderFloat("Effects GPU budget", &_frame_budget, 0.0f, 33.0f, _frame_budget > 0 ? "%.1f ms" : "Disabled");
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Lowers the render resolution of techniques marked as scalable when all effects together take longer than this on the GPU, and raises it again once there is enough time left.");
+
 		if (ImGui::Button("Clear effect cache", ImVec2(ImGui::CalcItemWidth(), 0)))
 			clear_effect_cache();
 		if (ImGui::IsItemHovered())
@@ -1640,6 +1674,7 @@ void reshade::runtime::draw_gui_statistics()
 		ImGui::TextUnformatted("Time:");
 		ImGui::Text("Frame %llu:", _framecount + 1);
 		ImGui::TextUnformatted("Post-Processing:");
+		ImGui::TextUnformatted("Barriers:");
 
 		ImGui::EndGroup();
 		ImGui::SameLine(ImGui::GetWindowWidth() * 0.33333333f);
@@ -1653,6 +1688,7 @@ void reshade::runtime::draw_gui_statistics()
 		ImGui::Text("%d-%d-%d %d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec);
 		ImGui::Text("%.2f fps", _imgui_context->IO.Framerate);
 		ImGui::Text("%*.3f ms CPU", cpu_digits + 4, post_processing_time_cpu * 1e-6f);
+		ImGui::Text("%u per frame", _last_frame_barrier_count);
 
 		ImGui::EndGroup();
 		ImGui::SameLine(ImGui::GetWindowWidth() * 0.66666666f);
@@ -1686,6 +1722,14 @@ void reshade::runtime::draw_gui_statistics()
 				ImGui::Text("%s (%zu passes)", tech.name.c_str(), tech.passes.size());
 			else
 				ImGui::TextUnformatted(tech.name.c_str());
+
+			// List individual passes too, so that it is visible which one is the expensive one
+			if (tech.passes.size() > 1 && tech.passes_data.size() == tech.passes.size())
+				for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
+					if (tech.passes[pass_index].name.empty())
+						ImGui::TextDisabled("  Pass %zu", pass_index);
+					else
+						ImGui::TextDisabled("  %s", tech.passes[pass_index].name.c_str());
 		}
 
 		ImGui::EndGroup();
@@ -1701,6 +1745,11 @@ void reshade::runtime::draw_gui_statistics()
 				ImGui::Text("%*.3f ms CPU", cpu_digits + 4, tech.average_cpu_duration * 1e-6f);
 			else
 				ImGui::NewLine();
+
+			// CPU time is only measured for the whole technique
+			if (tech.passes.size() > 1 && tech.passes_data.size() == tech.passes.size())
+				for (size_t pass_index = 0; pass_index < tech.passes.size(); ++pass_index)
+					ImGui::NewLine();
 		}
 
 		ImGui::EndGroup();
@@ -1717,9 +1766,71 @@ void reshade::runtime::draw_gui_statistics()
 				ImGui::Text("%*.3f ms GPU", gpu_digits + 4, tech.average_gpu_duration * 1e-6f);
 			else
 				ImGui::NewLine();
+
+			if (tech.passes.size() > 1 && tech.passes_data.size() == tech.passes.size())
+				for (const technique::pass_data &pass_data : tech.passes_data)
+					if (_gather_gpu_statistics && pass_data.average_gpu_duration != 0)
+						ImGui::TextDisabled("%*.3f ms GPU", gpu_digits + 4, pass_data.average_gpu_duration * 1e-6f);
+					else
+						ImGui::NewLine();
 		}
 
 		ImGui::EndGroup();
+
+		if (ImGui::Button("Export trace", ImVec2(ImGui::GetContentRegionAvail().x, 0)))
+			save_trace();
+		if (ImGui::IsItemHovered())
+			ImGui::SetTooltip("Saves the CPU and GPU timings of the last %u frames in the Chrome trace event format (open in \"chrome://tracing\" or Perfetto).", _trace_frame_count);
+	}
+
+	if (ImGui::CollapsingHeader("Frame Time Distribution", ImGuiTreeNodeFlags_DefaultOpen))
+	{
+		const auto draw_percentiles = [](const char *label, const log_histogram &histogram) {
+			if (histogram.count() == 0)
+				return;
+			ImGui::Text("%-16s %8.3f ms %8.3f ms %8.3f ms %8.3f ms", label,
+				histogram.percentile(50.0) * 1e-6f,
+				histogram.percentile(95.0) * 1e-6f,
+				histogram.percentile(99.0) * 1e-6f,
+				histogram.percentile(99.9) * 1e-6f);
+		};
+
+		ImGui::Text("%-16s %11s %11s %11s %11s", "", "p50", "p95", "p99", "p99.9");
+		draw_percentiles("Frame:", _frame_time_histogram);
+		draw_percentiles("Effects CPU:", _effects_cpu_time_histogram);
+		draw_percentiles("Effects GPU:", _effects_gpu_time_histogram);
+
+		ImGui::Text("%llu frames recorded, %zu stutters", _frame_time_histogram.count(), _stutters.size());
+		ImGui::SameLine(ImGui::GetContentRegionAvail().x - 80);
+		if (ImGui::Button("Reset", ImVec2(80, 0)))
+		{
+			_frame_time_histogram.clear();
+			_effects_cpu_time_histogram.clear();
+			_effects_gpu_time_histogram.clear();
+			_stutters.clear();
+		}
+
+		// Show most recent stutters first
+		for (auto it = _stutters.rbegin(); it != _stutters.rend(); ++it)
+		{
+			const stutter_info &info = *it;
+
+			std::string label = "Frame " + std::to_string(info.framecount) + ": " +
+				std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(info.duration).count() / 1000.0f) + " ms (median " +
+				std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(info.median_duration).count() / 1000.0f) + " ms)";
+			if (info.reloading)
+				label += " during reload";
+
+			if (ImGui::TreeNodeEx(label.c_str(), ImGuiTreeNodeFlags_NoTreePushOnOpen))
+			{
+				ImGui::Indent();
+				for (const std::string &name : info.loading_techniques)
+					ImGui::Text("Loading: %s", name.c_str());
+				for (const std::string &name : info.enabled_techniques)
+					ImGui::TextDisabled("Enabled: %s", name.c_str());
+				ImGui::Unindent();
+			}
+		}
 	}
 
 	if (ImGui::CollapsingHeader("Render Targets & Textures", ImGuiTreeNodeFlags_DefaultOpen) && !is_loading())
@@ -1941,6 +2052,45 @@ void reshade::runtime::draw_gui_statistics()
 		}
 
 		ImGui::Text("Total memory usage: %lld.%03lld %s", memory_view.quot, memory_view.rem, memory_size_unit);
+
+		// Include textures of disabled techniques too, since those are only released after a delay
+		std::vector<int64_t> effect_memory_sizes(_effects.size());
+		int64_t pooled_memory_size = 0;
+		for (const texture &tex : _textures)
+		{
+			if (tex.resource == 0 || !tex.semantic.empty())
+				continue;
+
+			int64_t memory_size = 0;
+			for (uint32_t level = 0, width = tex.width, height = tex.height; level < tex.levels; ++level, width /= 2, height /= 2)
+				memory_size += width * height * pixel_sizes[static_cast<int>(tex.format)];
+
+			if (tex.shared.size() > 1)
+				pooled_memory_size += memory_size;
+			else
+				effect_memory_sizes[tex.effect_index] += memory_size;
+		}
+
+		for (size_t effect_index = 0; effect_index <= _effects.size(); ++effect_index)
+		{
+			const int64_t memory_size = effect_index < _effects.size() ? effect_memory_sizes[effect_index] : pooled_memory_size;
+			if (memory_size == 0)
+				continue;
+
+			if (memory_size >= 1024 * 1024) {
+				memory_view = std::lldiv(memory_size, 1024 * 1024);
+				memory_view.rem /= 1000;
+				memory_size_unit = "MiB";
+			}
+			else {
+				memory_view = std::lldiv(memory_size, 1024);
+				memory_size_unit = "KiB";
+			}
+
+			ImGui::Text("%s: %lld.%03lld %s",
+				effect_index < _effects.size() ? _effects[effect_index].source_file.filename().u8string().c_str() : "Pooled textures",
+				memory_view.quot, memory_view.rem, memory_size_unit);
+		}
 	}
 }
 void reshade::runtime::draw_gui_log()
@@ -6,6 +6,8 @@
 #pragma once
 
 #include "effect_module.hpp"
+#include "frame_budget.hpp"
+#include <chrono>
 
 namespace reshade
 {
@@ -27,6 +29,8 @@ namespace reshade
 		overlay_open,
 		overlay_active,
 		overlay_hovered,
+		render_scale,
+		phase,
 	};
 
 	template <typename T, size_t SAMPLES>
@@ -101,6 +105,9 @@ namespace reshade
 		size_t effect_index = std::numeric_limits<size_t>::max();
 		std::vector<size_t> shared;
 		bool loaded = false;
+		bool transient = false;
+		// Last time an enabled technique referenced this texture (see 'release_unused_textures')
+		std::chrono::high_resolution_clock::time_point last_used_time;
 
 		api::resource resource = {};
 		api::resource_view srv[2] = {};
@@ -182,13 +189,43 @@ namespace reshade
 			return std::string_view(it->value.string_data);
 		}
 
+		uint32_t current_phase(uint64_t framecount) const
+		{
+			return static_cast<uint32_t>((framecount + phase_offset) % (update_interval * interleave));
+		}
+
 		size_t effect_index = std::numeric_limits<size_t>::max();
 		bool hidden = false;
 		bool enabled = false;
+		bool compiling = false;
+		bool creating = false;
 		int64_t time_left = 0;
 		uint32_t toggle_key_data[4] = {};
+		// Passes writing to intermediate textures only run every "update_interval" frames, and then only on one of "interleave" bands of the render target
+		uint32_t update_interval = 1;
+		uint32_t interleave = 1;
+		uint32_t phase_offset = 0;
 		moving_average<uint64_t, 60> average_cpu_duration;
 		moving_average<uint64_t, 60> average_gpu_duration;
+		// Render scale of this technique, which is reduced when effects exceed the frame budget and the technique is marked as "scalable"
+		frame_budget_controller::entry budget_state;
+		// Whether the "render_scale" and "phase" uniforms of the effect take their value from this technique, which is resolved when the effect is loaded
+		bool provides_render_scale = false;
+		bool provides_phase = false;
+
+		struct barrier_list
+		{
+			std::vector<api::resource> resources;
+			std::vector<api::resource_usage> state_old;
+			std::vector<api::resource_usage> state_new;
+
+			void push_back(api::resource resource, api::resource_usage old_state, api::resource_usage new_state)
+			{
+				resources.push_back(resource);
+				state_old.push_back(old_state);
+				state_new.push_back(new_state);
+			}
+		};
 
 		struct pass_data
 		{
@@ -199,12 +236,53 @@ namespace reshade
 			api::descriptor_set storage_set = {};
 			std::vector<api::resource> modified_resources;
 			std::vector<api::resource_view> generate_mipmap_views;
+			barrier_list barriers_before;
+			barrier_list barriers_after;
+			bool reads_backbuffer = false;
+			moving_average<uint64_t, 60> average_gpu_duration;
 		};
 
 		std::vector<pass_data> passes_data;
 		uint32_t query_base_index = 0;
 	};
 
+	struct special_uniform_update final
+	{
+		enum class key_mode
+		{
+			down,
+			press,
+			toggle,
+		};
+
+		special_uniform source = special_uniform::none;
+		size_t uniform_index = 0;
+
+		// Annotation parameters of the variable, which are resolved when the effect is loaded
+		int index = 0;
+		key_mode mode = key_mode::down;
+		int int_range[2] = {};
+		float range[2] = {};
+		float step[2] = {};
+		float smoothing = 0.0f;
+	};
+
+	struct compiled_technique final
+	{
+		size_t effect_index = std::numeric_limits<size_t>::max();
+		std::string name;
+		std::string errors;
+		bool success = false;
+		std::vector<std::pair<std::string, std::pair<std::string, std::string>>> assembly;
+	};
+
+	struct created_pipelines final
+	{
+		size_t effect_index = std::numeric_limits<size_t>::max();
+		bool success = false;
+		std::vector<std::string> technique_names;
+	};
+
 	struct effect final
 	{
 		unsigned int rendering = 0;
@@ -219,7 +297,14 @@ namespace reshade
 		std::vector<std::pair<std::string, std::string>> definitions;
 		std::unordered_map<std::string, std::pair<std::string, std::string>> assembly;
 		std::vector<uniform> uniforms;
+		std::vector<special_uniform_update> special_uniforms;
 		std::vector<unsigned char> uniform_data_storage;
+		// Byte range of the uniform data that was modified since it was last uploaded to the constant buffer
+		size_t uniform_data_dirty_begin = 0;
+		size_t uniform_data_dirty_end = std::numeric_limits<size_t>::max();
+		// Values of the "render_scale" and "phase" uniforms, which are copied from the technique that provides them every frame
+		float render_scale = 1.0f;
+		uint32_t phase[2] = {};
 
 		struct binding_data
 		{
@@ -231,11 +316,14 @@ namespace reshade
 		};
 
 		api::resource cb = {};
+		void *cb_mapped = nullptr;
 		api::pipeline_layout layout = {};
 		api::descriptor_set_layout set_layouts[4] = {};
 		api::descriptor_set cb_set = {};
 		api::descriptor_set sampler_set = {};
 		api::query_pool query_heap = {};
 		std::vector<binding_data> texture_semantic_to_binding;
+		// Pipelines kept from a previous load of this effect variant (see 'reload_effects'), which are used in 'create_effect' instead of creating them again
+		std::unordered_map<std::string, std::vector<api::pipeline>> cached_pipelines;
 	};
 }
@@ -24,6 +24,8 @@ reshade::vulkan::swapchain_impl::swapchain_impl(device_impl *device, command_que
 	_vendor_id = device_props.vendorID;
 	_device_id = device_props.deviceID;
 
+	_timestamp_period = device_props.limits.timestampPeriod;
+
 	// NVIDIA has a custom driver version scheme, so extract the proper minor version from it
 	const uint32_t driver_minor_version = _vendor_id == 0x10DE ?
 		(device_props.driverVersion >> 14) & 0xFF : VK_VERSION_MINOR(device_props.driverVersion);
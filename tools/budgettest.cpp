@@ -0,0 +1,181 @@
+/**
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#include "frame_budget.hpp"
+#include <cstdio>
+#include <vector>
+
+using reshade::frame_budget_controller;
+
+struct synthetic_technique
+{
+	const char *name;
+	bool scalable;
+	// GPU time in nanoseconds at full render scale, which scales with the number of pixels rendered
+	double full_cost;
+};
+
+struct scenario
+{
+	const char *name;
+	std::vector<synthetic_technique> techniques;
+	// Budget in nanoseconds
+	uint64_t budget;
+	// Factor the cost of all techniques changes by halfway through the trace, to simulate a scene change
+	double cost_factor_second_half = 1.0;
+	// Relative amount of random variation added to every measurement
+	double noise = 0.0;
+	unsigned int num_frames = 3000;
+};
+
+struct scenario_result
+{
+	std::vector<float> final_scales;
+	double final_total_cost = 0.0;
+	unsigned int last_change_frame = 0;
+	unsigned int direction_reversals = 0;
+};
+
+// Deterministic pseudo-random numbers, so that every run replays the exact same trace
+static uint32_t s_random_state = 1;
+
+static double next_random()
+{
+	s_random_state = s_random_state * 1664525u + 1013904223u;
+	return (s_random_state >> 8) / static_cast<double>(1u << 24);
+}
+
+static scenario_result replay(const scenario &s)
+{
+	s_random_state = 1;
+
+	std::vector<frame_budget_controller::entry> entries(s.techniques.size());
+	std::vector<frame_budget_controller::entry *> entry_pointers;
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		entries[i].scalable = s.techniques[i].scalable;
+		entry_pointers.push_back(&entries[i]);
+	}
+
+	frame_budget_controller controller;
+	scenario_result result;
+	int last_direction = 0;
+
+	for (unsigned int frame = 0; frame < s.num_frames; ++frame)
+	{
+		const double cost_factor = frame < s.num_frames / 2 ? 1.0 : s.cost_factor_second_half;
+
+		result.final_total_cost = 0.0;
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			const double cost = s.techniques[i].full_cost * cost_factor * entries[i].scale * entries[i].scale * (1.0 + s.noise * (2.0 * next_random() - 1.0));
+			entries[i].record(static_cast<uint64_t>(cost));
+			result.final_total_cost += s.techniques[i].full_cost * cost_factor * entries[i].scale * entries[i].scale;
+		}
+
+		float scale_sum_before = 0.0f;
+		for (const frame_budget_controller::entry &entry : entries)
+			scale_sum_before += entry.scale;
+
+		if (!controller.update(entry_pointers.data(), entry_pointers.size(), s.budget))
+			continue;
+
+		float scale_sum_after = 0.0f;
+		for (const frame_budget_controller::entry &entry : entries)
+			scale_sum_after += entry.scale;
+
+		const int direction = scale_sum_after < scale_sum_before ? -1 : 1;
+		if (last_direction != 0 && direction != last_direction)
+			result.direction_reversals++;
+		last_direction = direction;
+		result.last_change_frame = frame;
+	}
+
+	for (const frame_budget_controller::entry &entry : entries)
+		result.final_scales.push_back(entry.scale);
+
+	return result;
+}
+
+static unsigned int s_failures = 0;
+
+static void check(const scenario &s, bool condition, const char *message)
+{
+	if (condition)
+		return;
+
+	printf("FAILED: %s: %s\n", s.name, message);
+	s_failures++;
+}
+
+int main()
+{
+	constexpr uint64_t budget = 4'000'000; // 4 ms
+
+	// Scenario names are printed on failure, so keep them descriptive
+	{
+		const scenario s = { "Over budget", { { "Bloom", true, 3'000'000.0 }, { "DOF", true, 2'000'000.0 }, { "Sharpen", false, 500'000.0 } }, budget };
+		const scenario_result r = replay(s);
+
+		check(s, r.final_total_cost <= budget, "Did not converge to within the budget");
+		check(s, r.last_change_frame < s.num_frames / 2, "Render scales still changed late in the trace");
+		check(s, r.direction_reversals == 0, "Render scales were increased again while the load stayed the same");
+		check(s, r.final_scales[2] == 1.0f, "Render scale of a technique that is not scalable was changed");
+	}
+	{
+		const scenario s = { "Within budget", { { "Bloom", true, 1'000'000.0 }, { "DOF", true, 1'000'000.0 } }, budget };
+		const scenario_result r = replay(s);
+
+		check(s, r.final_scales[0] == 1.0f && r.final_scales[1] == 1.0f, "Render scale was reduced although the budget was never exceeded");
+		check(s, r.last_change_frame == 0, "Render scales changed although the budget was never exceeded");
+	}
+	{
+		// Cost drops to a third halfway through, so the render scales should be restored to full
+		const scenario s = { "Recovery", { { "Bloom", true, 3'000'000.0 }, { "DOF", true, 3'000'000.0 } }, budget, 1.0 / 3.0 };
+		const scenario_result r = replay(s);
+
+		check(s, r.final_scales[0] == 1.0f && r.final_scales[1] == 1.0f, "Render scales were not restored after the load dropped");
+		check(s, r.direction_reversals == 1, "Render scales changed direction more than once");
+	}
+	{
+		// At full scale this is just over the budget, while one step lower is below it but above the headroom, which must not flip back and forth
+		const scenario s = { "Borderline", { { "Bloom", true, 4'100'000.0 } }, budget };
+		const scenario_result r = replay(s);
+
+		check(s, r.final_total_cost <= budget, "Did not converge to within the budget");
+		check(s, r.direction_reversals == 0, "Render scale oscillated around the budget");
+	}
+	{
+		const scenario s = { "Noisy", { { "Bloom", true, 3'000'000.0 }, { "DOF", true, 2'000'000.0 } }, budget, 1.0, 0.2 };
+		const scenario_result r = replay(s);
+
+		check(s, r.final_total_cost <= budget, "Did not converge to within the budget");
+		check(s, r.last_change_frame < s.num_frames / 2, "Render scales kept changing because of measurement noise");
+		check(s, r.direction_reversals == 0, "Render scales oscillated because of measurement noise");
+	}
+	{
+		// Budget cannot be reached even at the lowest render scale, so that is where the techniques should stay
+		const scenario s = { "Unreachable", { { "Bloom", true, 20'000'000.0 }, { "DOF", true, 20'000'000.0 } }, budget };
+		const scenario_result r = replay(s);
+
+		check(s, r.final_scales[0] == frame_budget_controller::MIN_SCALE && r.final_scales[1] == frame_budget_controller::MIN_SCALE, "Render scales did not reach the minimum");
+		check(s, r.direction_reversals == 0, "Render scales were increased although the budget is still exceeded");
+	}
+	{
+		const scenario s = { "Not scalable", { { "Bloom", false, 6'000'000.0 } }, budget };
+		const scenario_result r = replay(s);
+
+		check(s, r.final_scales[0] == 1.0f, "Render scale of a technique that is not scalable was changed");
+	}
+
+	if (s_failures != 0)
+	{
+		printf("%u check(s) failed\n", s_failures);
+		return 1;
+	}
+
+	printf("All checks passed\n");
+	return 0;
+}
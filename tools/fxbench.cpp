@@ -0,0 +1,452 @@
+/**
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+#include "effect_lexer.hpp"
+#include "effect_parser.hpp"
+#include "effect_codegen.hpp"
+#include "effect_preprocessor.hpp"
+#include "version.h"
+#include <new>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+// Track every heap allocation made by the compiler, so that the number of allocations and the peak memory usage of each phase can be reported
+// The size of each allocation is stored in front of it, with enough padding to keep the alignment guarantees of the default allocator
+static constexpr size_t s_alloc_header_size = alignof(std::max_align_t);
+static size_t s_alloc_count = 0;
+static size_t s_live_bytes = 0;
+static size_t s_peak_bytes = 0;
+
+void *operator new(size_t size)
+{
+	void *const ptr = std::malloc(size + s_alloc_header_size);
+	if (ptr == nullptr)
+		std::abort();
+
+	*static_cast<size_t *>(ptr) = size;
+	s_alloc_count++;
+	s_live_bytes += size;
+	s_peak_bytes = std::max(s_peak_bytes, s_live_bytes);
+
+	return static_cast<char *>(ptr) + s_alloc_header_size;
+}
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+void operator delete(void *ptr) noexcept
+{
+	if (ptr == nullptr)
+		return;
+
+	ptr = static_cast<char *>(ptr) - s_alloc_header_size;
+	s_live_bytes -= *static_cast<size_t *>(ptr);
+
+	std::free(ptr);
+}
+void operator delete[](void *ptr) noexcept
+{
+	operator delete(ptr);
+}
+void operator delete(void *ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+void operator delete[](void *ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+struct phase_result
+{
+	std::string file;
+	std::string phase;
+	double median_seconds = 0.0;
+	double mb_per_second = 0.0;
+	double tokens_per_second = 0.0;
+	size_t allocations = 0;
+	size_t peak_bytes = 0;
+};
+
+struct baseline_entry
+{
+	// Zero if the baseline was saved without timings, in which case throughput is not compared
+	double mb_per_second = 0.0;
+	size_t allocations = 0;
+	size_t peak_bytes = 0;
+};
+
+static void print_usage(const char *path)
+{
+	printf(R"(usage: %s [options] <filename or directory>...
+
+Runs every effect file through the preprocessor, lexer, parser and each code generation backend separately and reports their throughput, number of allocations and peak memory usage.
+Directories are searched for files with the ".fx" extension.
+
+Options:
+  -h, --help                Print this help.
+  --version                 Print ReShade version.
+
+  -D <id>=<text>            Define a preprocessor macro.
+  -I <path>                 Add directory to include search path.
+
+  --width                   Value of the 'BUFFER_WIDTH' preprocessor macro.
+  --height                  Value of the 'BUFFER_HEIGHT' preprocessor macro.
+  --shader-model <value>    HLSL shader model version. Can be 30, 40, 41, 50, ...
+
+  --iterations <count>      Number of times each phase is run, of which the median time is reported. Defaults to 10.
+  --save-baseline <file>    Write the results to the given file, to compare later runs against.
+  --baseline <file>         Compare the results against the given file and fail if any phase regressed.
+  --tolerance <percent>     Allowed deviation from the baseline before a phase is considered regressed. Defaults to 10.
+  --no-timings              Only save and compare the allocation counts and peak memory usage, which are deterministic for a given build.
+
+Throughput depends on the machine, so it is only meaningful to compare against a baseline saved on the same machine.
+Allocation counts and peak memory usage only depend on the compiler and standard library the tool was built with.
+For continuous integration, save a baseline with "--no-timings --save-baseline" from the Release build of the target branch, then run the changed build with "--no-timings --baseline" against it on the same build agent.
+	)", path);
+}
+
+// Runs a phase the specified number of times and measures the median time, the number of allocations per run and the peak memory usage above what was in use before
+template <typename F>
+static bool measure(unsigned int iterations, phase_result &result, F &&func)
+{
+	std::vector<double> times;
+	times.reserve(iterations);
+
+	for (unsigned int i = 0; i < iterations; ++i)
+	{
+		const size_t live_bytes_before = s_live_bytes;
+		const size_t alloc_count_before = s_alloc_count;
+		s_peak_bytes = live_bytes_before;
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		if (!func())
+			return false;
+		const auto end = std::chrono::high_resolution_clock::now();
+
+		times.push_back(std::chrono::duration<double>(end - start).count());
+
+		// These are deterministic, so simply keep the value of the last run
+		result.allocations = s_alloc_count - alloc_count_before;
+		result.peak_bytes = std::max(result.peak_bytes, s_peak_bytes - live_bytes_before);
+	}
+
+	std::sort(times.begin(), times.end());
+	result.median_seconds = times[times.size() / 2];
+	return true;
+}
+
+static bool load_baseline(const std::filesystem::path &path, std::vector<std::pair<std::string, baseline_entry>> &baseline)
+{
+	std::ifstream file(path);
+	if (!file)
+		return false;
+
+	// Each line has the format "<phase> <MB/s> <allocations> <peak bytes> <file>", where the throughput is "-" if the baseline was saved without timings
+	for (std::string line; std::getline(file, line);)
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream stream(line);
+		std::string phase, mb_per_second, name;
+		baseline_entry entry;
+		if (!(stream >> phase >> mb_per_second >> entry.allocations >> entry.peak_bytes >> std::ws) || !std::getline(stream, name))
+			return false;
+		if (mb_per_second != "-")
+			entry.mb_per_second = std::strtod(mb_per_second.c_str(), nullptr);
+
+		baseline.emplace_back(name + ' ' + phase, entry);
+	}
+
+	return true;
+}
+
+static bool save_baseline(const std::filesystem::path &path, const std::vector<phase_result> &results, bool timings)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	file << "# Generated by fxbench " << VERSION_STRING_PRODUCT << '\n';
+	file << "# <phase> <MB/s> <allocations> <peak bytes> <file>\n";
+
+	for (const phase_result &result : results)
+	{
+		file << result.phase << ' ';
+		if (timings)
+			file << result.mb_per_second;
+		else
+			file << '-';
+		file << ' ' << result.allocations << ' ' << result.peak_bytes << ' ' << result.file << '\n';
+	}
+
+	return file.good();
+}
+
+int main(int argc, char *argv[])
+{
+	std::vector<std::filesystem::path> inputs;
+	std::vector<std::filesystem::path> include_paths;
+	std::vector<std::pair<std::string, std::string>> macros;
+	const char *baseline_path = nullptr;
+	const char *save_baseline_path = nullptr;
+	const char *buffer_width = "800";
+	const char *buffer_height = "600";
+	double tolerance = 10.0;
+	bool timings = true;
+	unsigned int iterations = 10;
+	unsigned int shader_model = 50;
+
+	macros.emplace_back("__RESHADE__", std::to_string(VERSION_MAJOR * 10000 + VERSION_MINOR * 100 + VERSION_REVISION));
+	macros.emplace_back("__RESHADE_PERFORMANCE_MODE__", "0");
+
+	// Parse command-line arguments
+	for (int i = 1; i < argc; ++i)
+	{
+		if (const char *arg = argv[i]; arg[0] == '-')
+		{
+			if (0 == std::strcmp(arg, "-h") || 0 == std::strcmp(arg, "--help"))
+			{
+				print_usage(argv[0]);
+				return 0;
+			}
+			if (0 == std::strcmp(arg, "--version"))
+			{
+				printf("%s\n", VERSION_STRING_PRODUCT);
+				return 0;
+			}
+			if (0 == std::strcmp(arg, "--no-timings"))
+			{
+				timings = false;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+				continue;
+
+			if (0 == std::strcmp(arg, "-D"))
+			{
+				char *macro = argv[++i];
+				char *value = std::strchr(macro, '=');
+				if (value) *value++ = '\0';
+				macros.emplace_back(macro, value ? value : "1");
+			}
+			else if (0 == std::strcmp(arg, "-I"))
+				include_paths.push_back(argv[++i]);
+			else if (0 == std::strcmp(arg, "--width"))
+				buffer_width = argv[++i];
+			else if (0 == std::strcmp(arg, "--height"))
+				buffer_height = argv[++i];
+			else if (0 == std::strcmp(arg, "--shader-model"))
+				shader_model = std::strtol(argv[++i], nullptr, 10);
+			else if (0 == std::strcmp(arg, "--iterations"))
+				iterations = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+			else if (0 == std::strcmp(arg, "--baseline"))
+				baseline_path = argv[++i];
+			else if (0 == std::strcmp(arg, "--save-baseline"))
+				save_baseline_path = argv[++i];
+			else if (0 == std::strcmp(arg, "--tolerance"))
+				tolerance = std::strtod(argv[++i], nullptr);
+		}
+		else
+		{
+			std::error_code ec;
+			if (std::filesystem::is_directory(arg, ec))
+			{
+				std::vector<std::filesystem::path> files;
+				for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(arg, ec))
+					if (entry.path().extension() == ".fx")
+						files.push_back(entry.path());
+
+				// Keep the order stable between runs, so that output can be compared directly
+				std::sort(files.begin(), files.end());
+				inputs.insert(inputs.end(), files.begin(), files.end());
+			}
+			else
+			{
+				inputs.push_back(arg);
+			}
+		}
+	}
+
+	if (inputs.empty())
+	{
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	macros.emplace_back("BUFFER_WIDTH", buffer_width);
+	macros.emplace_back("BUFFER_HEIGHT", buffer_height);
+	macros.emplace_back("BUFFER_RCP_WIDTH", "(1.0 / BUFFER_WIDTH)");
+	macros.emplace_back("BUFFER_RCP_HEIGHT", "(1.0 / BUFFER_HEIGHT)");
+
+	const auto setup_preprocessor = [&](reshadefx::preprocessor &pp) {
+		for (const std::pair<std::string, std::string> &macro : macros)
+			pp.add_macro_definition(macro.first, macro.second);
+		for (const std::filesystem::path &include_path : include_paths)
+			pp.add_include_path(include_path);
+	};
+
+	const std::pair<const char *, reshadefx::codegen *(*)(unsigned int)> backends[] = {
+		{ "spirv", [](unsigned int) { return reshadefx::create_codegen_spirv(true, false, false); } },
+		{ "glsl", [](unsigned int) { return reshadefx::create_codegen_glsl(false, false); } },
+		{ "hlsl", [](unsigned int shader_model) { return reshadefx::create_codegen_hlsl(shader_model, false, false); } },
+	};
+
+	std::vector<phase_result> results;
+
+	printf("%-24s %-10s %10s %10s %12s %10s %10s\n", "File", "Phase", "Time (ms)", "MB/s", "Mtokens/s", "Allocs", "Peak (KiB)");
+
+	for (const std::filesystem::path &path : inputs)
+	{
+		const std::string name = path.filename().u8string();
+
+		// Do one untimed run to validate the file and get the input size and token count that all throughput numbers are relative to
+		reshadefx::preprocessor pp;
+		setup_preprocessor(pp);
+		if (!pp.append_file(path))
+		{
+			std::cout << pp.errors() << std::endl;
+			return 1;
+		}
+
+		const std::string &source = pp.output();
+
+		size_t num_tokens = 0;
+		for (reshadefx::lexer lexer(source); lexer.lex().id != reshadefx::tokenid::end_of_file;)
+			num_tokens++;
+
+		std::vector<phase_result> file_results;
+
+		phase_result &preprocess_result = file_results.emplace_back();
+		preprocess_result.phase = "preprocess";
+		if (!measure(iterations, preprocess_result, [&]() {
+				reshadefx::preprocessor pp;
+				setup_preprocessor(pp);
+				return pp.append_file(path);
+			}))
+			return 1;
+
+		phase_result &lex_result = file_results.emplace_back();
+		lex_result.phase = "lex";
+		if (!measure(iterations, lex_result, [&]() {
+				reshadefx::lexer lexer(source);
+				while (lexer.lex().id != reshadefx::tokenid::end_of_file)
+					continue;
+				return true;
+			}))
+			return 1;
+
+		// The parser drives code generation directly, so these two cannot be measured independently and are reported together per backend
+		for (const auto &backend : backends)
+		{
+			phase_result &codegen_result = file_results.emplace_back();
+			codegen_result.phase = backend.first;
+
+			std::string errors;
+			if (!measure(iterations, codegen_result, [&]() {
+					const std::unique_ptr<reshadefx::codegen> codegen(backend.second(shader_model));
+
+					reshadefx::parser parser;
+					if (!parser.parse(source, codegen.get()))
+						return errors = parser.errors(), false;
+
+					reshadefx::module module;
+					codegen->write_result(module);
+					return true;
+				}))
+			{
+				std::cout << pp.errors() << errors << std::endl;
+				return 1;
+			}
+		}
+
+		for (phase_result &result : file_results)
+		{
+			result.file = name;
+			result.mb_per_second = source.size() / result.median_seconds / 1000000.0;
+			result.tokens_per_second = num_tokens / result.median_seconds;
+
+			printf("%-24s %-10s %10.3f %10.2f %12.2f %10zu %10zu\n",
+				name.c_str(),
+				result.phase.c_str(),
+				result.median_seconds * 1000.0,
+				result.mb_per_second,
+				result.tokens_per_second / 1000000.0,
+				result.allocations,
+				result.peak_bytes / 1024);
+
+			results.push_back(std::move(result));
+		}
+	}
+
+	if (save_baseline_path != nullptr)
+	{
+		if (!save_baseline(save_baseline_path, results, timings))
+		{
+			std::cout << "error: Failed to write baseline to " << save_baseline_path << std::endl;
+			return 1;
+		}
+	}
+
+	if (baseline_path != nullptr)
+	{
+		std::vector<std::pair<std::string, baseline_entry>> baseline;
+		if (!load_baseline(baseline_path, baseline))
+		{
+			std::cout << "error: Failed to read baseline from " << baseline_path << std::endl;
+			return 1;
+		}
+
+		// Throughput is allowed to vary by the tolerance in either direction, but only decreases are reported as regressions (and only if the baseline contains timings)
+		// Allocation counts and peak memory usage are deterministic for a given build, but use the same tolerance so that small changes do not break the comparison
+		const double factor = tolerance / 100.0;
+
+		unsigned int regressions = 0;
+		for (const phase_result &result : results)
+		{
+			const auto it = std::find_if(baseline.begin(), baseline.end(),
+				[key = result.file + ' ' + result.phase](const std::pair<std::string, baseline_entry> &entry) { return entry.first == key; });
+			if (it == baseline.end())
+			{
+				printf("warning: No baseline for phase '%s' of '%s'\n", result.phase.c_str(), result.file.c_str());
+				continue;
+			}
+
+			const baseline_entry &entry = it->second;
+
+			if (timings && entry.mb_per_second != 0.0 && result.mb_per_second < entry.mb_per_second * (1.0 - factor))
+				regressions++,
+				printf("regression: Throughput of phase '%s' of '%s' dropped from %.2f MB/s to %.2f MB/s (%+.1f%%)\n",
+					result.phase.c_str(), result.file.c_str(), entry.mb_per_second, result.mb_per_second, (result.mb_per_second / entry.mb_per_second - 1.0) * 100.0);
+			if (result.allocations > entry.allocations * (1.0 + factor))
+				regressions++,
+				printf("regression: Allocations of phase '%s' of '%s' increased from %zu to %zu\n",
+					result.phase.c_str(), result.file.c_str(), entry.allocations, result.allocations);
+			if (result.peak_bytes > entry.peak_bytes * (1.0 + factor))
+				regressions++,
+				printf("regression: Peak memory usage of phase '%s' of '%s' increased from %zu KiB to %zu KiB\n",
+					result.phase.c_str(), result.file.c_str(), entry.peak_bytes / 1024, result.peak_bytes / 1024);
+		}
+
+		if (regressions != 0)
+		{
+			printf("%u regression(s) compared to baseline (tolerance %.1f%%)\n", regressions, tolerance);
+			return 1;
+		}
+
+		printf("No regressions compared to baseline (tolerance %.1f%%)\n", tolerance);
+	}
+
+	return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+// Separable gaussian blur with a configurable kernel, exercising macros, loops and multiple passes through intermediate textures
+
+#include "Common.fxh"
+
+#ifndef BLUR_SAMPLES
+	#define BLUR_SAMPLES 9
+#endif
+#if BLUR_SAMPLES < 2 || BLUR_SAMPLES > 9
+	#error "BLUR_SAMPLES has to be between 2 and 9"
+#endif
+#ifndef BLUR_DOWNSCALE
+	#define BLUR_DOWNSCALE 2
+#endif
+
+#define BLUR_WIDTH (BUFFER_WIDTH / BLUR_DOWNSCALE)
+#define BLUR_HEIGHT (BUFFER_HEIGHT / BLUR_DOWNSCALE)
+
+uniform float BlurRadius <
+	ui_type = "slider";
+	ui_min = 0.0; ui_max = 8.0;
+	ui_label = "Radius";
+	ui_tooltip = "Distance between samples in pixels.";
+> = 1.5;
+uniform float BlurStrength <
+	ui_type = "slider";
+	ui_min = 0.0; ui_max = 1.0;
+	ui_label = "Strength";
+> = 0.75;
+uniform bool DepthAware <
+	ui_label = "Preserve edges using depth";
+> = true;
+
+texture BlurHorizontalTex { Width = BLUR_WIDTH; Height = BLUR_HEIGHT; Format = RGBA16F; };
+texture BlurVerticalTex { Width = BLUR_WIDTH; Height = BLUR_HEIGHT; Format = RGBA16F; };
+
+sampler BlurHorizontal { Texture = BlurHorizontalTex; AddressU = CLAMP; AddressV = CLAMP; };
+sampler BlurVertical { Texture = BlurVerticalTex; AddressU = CLAMP; AddressV = CLAMP; };
+
+static const float Weights[9] = {
+	0.1762, 0.1585, 0.1153, 0.0678, 0.0322, 0.0124, 0.0038, 0.0009, 0.0002
+};
+
+float4 Blur(sampler s, float2 texcoord, float2 direction)
+{
+	const float2 step_size = direction * BlurRadius * BLUR_DOWNSCALE * BUFFER_PIXEL_SIZE;
+	const float center_depth = Common::GetLinearizedDepth(texcoord);
+
+	float4 color = tex2D(s, texcoord) * Weights[0];
+	float weight_sum = Weights[0];
+
+	[unroll]
+	for (int i = 1; i < BLUR_SAMPLES; ++i)
+	{
+		[unroll]
+		for (int side = -1; side <= 1; side += 2)
+		{
+			const float2 offset_texcoord = texcoord + side * i * step_size;
+
+			float weight = Weights[i];
+			if (DepthAware)
+				weight *= saturate(1.0 - abs(Common::GetLinearizedDepth(offset_texcoord) - center_depth) * 100.0);
+
+			color += tex2D(s, offset_texcoord) * weight;
+			weight_sum += weight;
+		}
+	}
+
+	return color / max(weight_sum, 1e-6);
+}
+
+float4 HorizontalPS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_Target
+{
+	return Blur(Common::BackBuffer, texcoord, float2(1.0, 0.0));
+}
+float4 VerticalPS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_Target
+{
+	return Blur(BlurHorizontal, texcoord, float2(0.0, 1.0));
+}
+float4 CombinePS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_Target
+{
+	const float4 original = tex2D(Common::BackBuffer, texcoord);
+	const float4 blurred = tex2D(BlurVertical, texcoord);
+	return lerp(original, blurred, BlurStrength);
+}
+
+technique Blur < ui_tooltip = "Separable gaussian blur (" STRINGIFY(BLUR_SAMPLES) " samples)"; >
+{
+	pass Horizontal
+	{
+		VertexShader = PostProcessVS;
+		PixelShader = HorizontalPS;
+		RenderTarget = BlurHorizontalTex;
+	}
+	pass Vertical
+	{
+		VertexShader = PostProcessVS;
+		PixelShader = VerticalPS;
+		RenderTarget = BlurVerticalTex;
+	}
+	pass Combine
+	{
+		VertexShader = PostProcessVS;
+		PixelShader = CombinePS;
+	}
+}
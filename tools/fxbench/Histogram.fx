@@ -0,0 +1,127 @@
+/**
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+// Luminance histogram and auto exposure, exercising compute shaders, shared memory, atomics and storage writes
+
+#include "Common.fxh"
+
+#if HAS_COMPUTE
+
+#define HISTOGRAM_BINS 256
+#define GROUP_SIZE 16
+#define DISPATCH_X ((BUFFER_WIDTH + GROUP_SIZE - 1) / GROUP_SIZE)
+#define DISPATCH_Y ((BUFFER_HEIGHT + GROUP_SIZE - 1) / GROUP_SIZE)
+
+uniform float MinLogLuma < ui_type = "slider"; ui_min = -16.0; ui_max = 0.0; > = -10.0;
+uniform float MaxLogLuma < ui_type = "slider"; ui_min = 0.0; ui_max = 16.0; > = 2.0;
+uniform float Adaptation < ui_type = "slider"; ui_min = 0.0; ui_max = 10.0; > = 1.1;
+
+texture HistogramTex { Width = HISTOGRAM_BINS; Height = 1; Format = R32F; };
+texture ExposureTex { Width = 1; Height = 1; Format = R32F; };
+
+sampler Histogram { Texture = HistogramTex; MinFilter = POINT; MagFilter = POINT; };
+sampler Exposure { Texture = ExposureTex; };
+
+storage HistogramStorage { Texture = HistogramTex; };
+storage ExposureStorage { Texture = ExposureTex; };
+
+groupshared uint LocalBins[HISTOGRAM_BINS];
+groupshared float LocalWeights[HISTOGRAM_BINS];
+
+uint LumaToBin(float3 color)
+{
+	const float luma = Common::Luma(color);
+	if (luma < 1e-5)
+		return 0;
+
+	const float log_luma = saturate((log2(luma) - MinLogLuma) / (MaxLogLuma - MinLogLuma));
+	return uint(log_luma * (HISTOGRAM_BINS - 2) + 1.0);
+}
+
+void ClearCS(uint3 tid : SV_DispatchThreadID)
+{
+	tex2Dstore(HistogramStorage, int2(tid.x, 0), 0.0);
+}
+
+void BuildCS(uint3 id : SV_DispatchThreadID, uint local_index : SV_GroupIndex)
+{
+	LocalBins[local_index] = 0;
+	barrier();
+
+	if (all(id.xy < uint2(BUFFER_WIDTH, BUFFER_HEIGHT)))
+	{
+		const float3 color = tex2Dfetch(Common::BackBuffer, int2(id.xy)).rgb;
+		atomicAdd(LocalBins[LumaToBin(color)], 1);
+	}
+
+	groupMemoryBarrier();
+	barrier();
+
+	// Accumulate into the global histogram (which is stored as float, so this is not exact across groups)
+	const float previous = tex2Dfetch(Histogram, int2(local_index, 0)).x;
+	tex2Dstore(HistogramStorage, int2(local_index, 0), previous + float(LocalBins[local_index]));
+}
+
+void AverageCS(uint local_index : SV_GroupIndex)
+{
+	const float count = tex2Dfetch(Histogram, int2(local_index, 0)).x;
+	LocalWeights[local_index] = count * local_index;
+	barrier();
+
+	[unroll]
+	for (uint cutoff = HISTOGRAM_BINS / 2; cutoff > 0; cutoff >>= 1)
+	{
+		if (local_index < cutoff)
+			LocalWeights[local_index] += LocalWeights[local_index + cutoff];
+		barrier();
+	}
+
+	if (local_index == 0)
+	{
+		const float pixels = BUFFER_WIDTH * BUFFER_HEIGHT;
+		const float weighted_log_average = (LocalWeights[0] / max(pixels - count, 1.0)) - 1.0;
+		const float average_luma = exp2(((weighted_log_average / (HISTOGRAM_BINS - 2)) * (MaxLogLuma - MinLogLuma)) + MinLogLuma);
+
+		const float previous = tex2Dfetch(Exposure, int2(0, 0)).x;
+		const float adapted = previous + (average_luma - previous) * (1.0 - exp(-Common::FrameTime * 0.001 * Adaptation));
+		tex2Dstore(ExposureStorage, int2(0, 0), adapted);
+	}
+}
+
+float4 ApplyPS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_Target
+{
+	const float3 color = tex2D(Common::BackBuffer, texcoord).rgb;
+	const float exposure = 0.18 / max(tex2Dfetch(Exposure, int2(0, 0)).x, 1e-4);
+	return float4(Common::LinearToSRGB(Common::SRGBToLinear(color) * exposure), 1.0);
+}
+
+technique AutoExposure
+{
+	pass Clear
+	{
+		ComputeShader = ClearCS<HISTOGRAM_BINS, 1>;
+		DispatchSizeX = 1;
+		DispatchSizeY = 1;
+	}
+	pass Build
+	{
+		ComputeShader = BuildCS<GROUP_SIZE, GROUP_SIZE>;
+		DispatchSizeX = DISPATCH_X;
+		DispatchSizeY = DISPATCH_Y;
+	}
+	pass Average
+	{
+		ComputeShader = AverageCS<HISTOGRAM_BINS, 1>;
+		DispatchSizeX = 1;
+		DispatchSizeY = 1;
+	}
+	pass Apply
+	{
+		VertexShader = PostProcessVS;
+		PixelShader = ApplyPS;
+	}
+}
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * Copyright (C) 2014 Patrick Mours. All rights reserved.
+ * License: https://github.com/crosire/reshade#license
+ */
+
+// Collection of tone mapping operators, exercising structs, function calls, switch statements and multiple techniques
+
+#include "Common.fxh"
+
+uniform int Operator <
+	ui_type = "combo";
+	ui_items = "Reinhard\0Reinhard (luminance)\0Filmic\0ACES\0Uncharted 2\0";
+	ui_label = "Operator";
+> = 3;
+uniform float Exposure <
+	ui_type = "drag";
+	ui_min = -4.0; ui_max = 4.0; ui_step = 0.05;
+	ui_label = "Exposure (EV)";
+> = 0.0;
+uniform float WhitePoint <
+	ui_type = "drag";
+	ui_min = 1.0; ui_max = 16.0;
+> = 4.0;
+uniform float3 Lift < ui_type = "color"; > = float3(0.0, 0.0, 0.0);
+uniform float3 Gamma < ui_type = "color"; > = float3(1.0, 1.0, 1.0);
+uniform float3 Gain < ui_type = "color"; > = float3(1.0, 1.0, 1.0);
+
+struct FilmicParams
+{
+	float shoulder_strength;
+	float linear_strength;
+	float linear_angle;
+	float toe_strength;
+	float toe_numerator;
+	float toe_denominator;
+};
+
+static const float3x3 ACESInputMat = float3x3(
+	0.59719, 0.35458, 0.04823,
+	0.07600, 0.90834, 0.01566,
+	0.02840, 0.13383, 0.83777);
+static const float3x3 ACESOutputMat = float3x3(
+	 1.60475, -0.53108, -0.07367,
+	-0.10208,  1.10813, -0.00605,
+	-0.00327, -0.07276,  1.07602);
+
+FilmicParams DefaultFilmicParams()
+{
+	FilmicParams params;
+	params.shoulder_strength = 0.15;
+	params.linear_strength = 0.50;
+	params.linear_angle = 0.10;
+	params.toe_strength = 0.20;
+	params.toe_numerator = 0.02;
+	params.toe_denominator = 0.30;
+	return params;
+}
+
+float3 FilmicCurve(float3 x, FilmicParams p)
+{
+	return ((x * (p.shoulder_strength * x + p.linear_angle * p.linear_strength) + p.toe_strength * p.toe_numerator) /
+	        (x * (p.shoulder_strength * x + p.linear_strength) + p.toe_strength * p.toe_denominator)) - p.toe_numerator / p.toe_denominator;
+}
+
+float3 Reinhard(float3 color)
+{
+	return color / (1.0 + color) * (1.0 + color / (WhitePoint * WhitePoint));
+}
+float3 ReinhardLuminance(float3 color)
+{
+	const float luma = Common::Luma(color);
+	const float mapped = luma * (1.0 + luma / (WhitePoint * WhitePoint)) / (1.0 + luma);
+	return color * (mapped / max(luma, 1e-5));
+}
+float3 Filmic(float3 color)
+{
+	color = max(0.0, color - 0.004);
+	return (color * (6.2 * color + 0.5)) / (color * (6.2 * color + 1.7) + 0.06);
+}
+float3 ACES(float3 color)
+{
+	color = mul(ACESInputMat, color);
+	const float3 a = color * (color + 0.0245786) - 0.000090537;
+	const float3 b = color * (0.983729 * color + 0.4329510) + 0.238081;
+	return saturate(mul(ACESOutputMat, a / b));
+}
+float3 Uncharted2(float3 color)
+{
+	const FilmicParams params = DefaultFilmicParams();
+	return FilmicCurve(color * 2.0, params) / FilmicCurve(WhitePoint, params);
+}
+
+float3 ApplyOperator(float3 color, int op)
+{
+	switch (op)
+	{
+	case 0:
+		return Reinhard(color);
+	case 1:
+		return ReinhardLuminance(color);
+	case 2:
+		return Common::SRGBToLinear(Filmic(color));
+	case 3:
+		return ACES(color);
+	default:
+		return Uncharted2(color);
+	}
+}
+
+float3 LiftGammaGain(float3 color)
+{
+	color = color * (1.5 - 0.5 * Lift) + 0.5 * Lift - 0.5;
+	color = saturate(color);
+	color *= Gain;
+	return pow(abs(color), 1.0 / Gamma);
+}
+
+float4 TonemapPS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_Target
+{
+	float3 color = tex2D(Common::BackBuffer, texcoord).rgb;
+#if BUFFER_COLOR_SPACE <= 1
+	color = Common::SRGBToLinear(color);
+#endif
+	color *= exp2(Exposure);
+	color = ApplyOperator(color, Operator);
+#if BUFFER_COLOR_SPACE <= 1
+	color = Common::LinearToSRGB(color);
+#endif
+	return float4(color, 1.0);
+}
+
+float4 GradePS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_Target
+{
+	float3 color = tex2D(Common::BackBuffer, texcoord).rgb;
+	return float4(LiftGammaGain(color), 1.0);
+}
+
+float4 VignettePS(float4 position : SV_Position, float2 texcoord : TEXCOORD) : SV_Target
+{
+	float3 color = tex2D(Common::BackBuffer, texcoord).rgb;
+	float2 coord = (texcoord - 0.5) * float2(BUFFER_ASPECT_RATIO, 1.0) * 2.0;
+	const float falloff = 1.0 - smoothstep(0.5, 1.5, length(coord));
+	return float4(color * falloff, 1.0);
+}
+
+technique Tonemap
+{
+	pass
+	{
+		VertexShader = PostProcessVS;
+		PixelShader = TonemapPS;
+		SRGBWriteEnable = false;
+	}
+}
+
+technique Grade < ui_label = "Lift Gamma Gain"; >
+{
+	pass
+	{
+		VertexShader = PostProcessVS;
+		PixelShader = GradePS;
+	}
+}
+
+technique Vignette
+{
+	pass
+	{
+		VertexShader = PostProcessVS;
+		PixelShader = VignettePS;
+		BlendEnable = true;
+		SrcBlend = ONE;
+		DestBlend = ZERO;
+	}
+}
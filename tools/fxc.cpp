@@ -7,14 +7,19 @@
 #include "effect_codegen.hpp"
 #include "effect_preprocessor.hpp"
 #include "version.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <algorithm>
+#include <filesystem>
 
 static void print_usage(const char *path)
 {
-	printf(R"(usage: %s [options] <filename>
+	printf(R"(usage: %s [options] <filename>...
 
 Options:
   -h, --help                Print this help.
@@ -29,6 +34,7 @@ Options:
 
   --glsl                    Print GLSL code for the previously specified entry point.
   --hlsl                    Print HLSL code for the previously specified entry point.
+  --spirv                   Compile to SPIR-V (the default when neither of the above is specified).
   --shader-model <value>    HLSL shader model version. Can be 30, 40, 41, 50, ...
 
   --width                   Value of the 'BUFFER_WIDTH' preprocessor macro.
@@ -37,28 +43,297 @@ Options:
   --spec-constants          Convert uniform variables to specialization constants.
 
   -Zi                       Enable debug information.
+
+Batch mode:
+  Multiple input files, directories (which are searched for files with the ".fx" extension) and wildcards ('*' and '?' in the file name) can be specified.
+  In that case every input is validated with each of the selected backends (or all of them if none was selected) and no code is printed.
+
+  -j <count>                Number of inputs to compile in parallel. 0 uses one thread per processor. Defaults to 1.
+  --json <file>             Write a report with diagnostics, timings and output sizes of every input to the given file. If <file> is "-", then the report is written to standard output instead.
+
+Exit codes:
+  0                         All inputs compiled successfully.
+  1                         At least one input failed to compile.
+  2                         Invalid command-line, no input file found or the report could not be written.
 	)", path);
 }
 
+enum backend_type
+{
+	backend_spirv,
+	backend_glsl,
+	backend_hlsl,
+	backend_count
+};
+
+static const char *const s_backend_names[backend_count] = { "spirv", "glsl", "hlsl" };
+
+struct compile_options
+{
+	std::vector<std::pair<std::string, std::string>> macros;
+	std::vector<std::filesystem::path> include_paths;
+	bool backends[backend_count] = {};
+	bool debug_info = false;
+	bool invert_y_axis = false;
+	bool spec_constants = false;
+	unsigned int shader_model = 50;
+};
+
+struct compile_result
+{
+	struct backend_result
+	{
+		bool compiled = false;
+		bool success = false;
+		double milliseconds = 0.0;
+		size_t output_size = 0;
+	};
+
+	bool success = false;
+	std::string errors;
+	double preprocess_milliseconds = 0.0;
+	size_t preprocessed_size = 0;
+	backend_result backends[backend_count];
+};
+
+static double elapsed_milliseconds(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static bool matches_wildcard(const char *name, const char *pattern)
+{
+	for (; *pattern != '\0'; ++name, ++pattern)
+	{
+		if (*pattern == '*')
+		{
+			// Try to match the rest of the pattern at every remaining position
+			for (; *name != '\0'; ++name)
+				if (matches_wildcard(name, pattern + 1))
+					return true;
+			return matches_wildcard(name, pattern + 1);
+		}
+
+		if (*name == '\0' || (*pattern != '?' && *pattern != *name))
+			return false;
+	}
+
+	return *name == '\0';
+}
+
+static bool expand_input(const char *arg, std::vector<std::filesystem::path> &inputs)
+{
+	const std::filesystem::path path = std::filesystem::u8path(arg);
+	const std::string pattern = path.filename().u8string();
+
+	std::error_code ec;
+	std::vector<std::filesystem::path> files;
+
+	if (pattern.find_first_of("*?") != std::string::npos)
+	{
+		const std::filesystem::path parent_path = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+
+		for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(parent_path, ec))
+			if (entry.is_regular_file(ec) && matches_wildcard(entry.path().filename().u8string().c_str(), pattern.c_str()))
+				files.push_back(entry.path());
+	}
+	else if (std::filesystem::is_directory(path, ec))
+	{
+		for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(path, ec))
+			if (entry.path().extension() == ".fx")
+				files.push_back(entry.path());
+	}
+	else
+	{
+		inputs.push_back(path);
+		return true;
+	}
+
+	// Keep the order stable between runs, so that reports can be compared directly
+	std::sort(files.begin(), files.end());
+	inputs.insert(inputs.end(), files.begin(), files.end());
+
+	return !files.empty();
+}
+
+static reshadefx::codegen *create_codegen(backend_type type, const compile_options &options)
+{
+	switch (type)
+	{
+	case backend_glsl:
+		return reshadefx::create_codegen_glsl(options.debug_info, options.spec_constants);
+	case backend_hlsl:
+		return reshadefx::create_codegen_hlsl(options.shader_model, options.debug_info, options.spec_constants);
+	default:
+		return reshadefx::create_codegen_spirv(true, options.debug_info, options.spec_constants, false, options.invert_y_axis);
+	}
+}
+
+static void setup_preprocessor(reshadefx::preprocessor &pp, const compile_options &options)
+{
+	for (const std::pair<std::string, std::string> &macro : options.macros)
+		pp.add_macro_definition(macro.first, macro.second);
+	for (const std::filesystem::path &include_path : options.include_paths)
+		pp.add_include_path(include_path);
+}
+
+static void compile_file(const std::filesystem::path &path, const compile_options &options, reshadefx::preprocessor::include_cache &cache, compile_result &result)
+{
+	reshadefx::preprocessor pp;
+	pp.set_include_cache(&cache);
+	setup_preprocessor(pp, options);
+
+	const auto preprocess_start = std::chrono::high_resolution_clock::now();
+	const bool preprocess_success = pp.append_file(path);
+	result.preprocess_milliseconds = elapsed_milliseconds(preprocess_start);
+	result.preprocessed_size = pp.output().size();
+	result.errors = pp.errors();
+
+	if (!preprocess_success)
+	{
+		if (result.errors.empty())
+			result.errors = path.u8string() + ": error: could not open input file\n";
+		return;
+	}
+
+	result.success = true;
+
+	std::string previous_parser_errors;
+	for (int type = 0; type < backend_count; ++type)
+	{
+		if (!options.backends[type])
+			continue;
+
+		compile_result::backend_result &backend_result = result.backends[type];
+		backend_result.compiled = true;
+
+		// The parser drives code generation directly, so parsing is included in the time of each backend
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		const std::unique_ptr<reshadefx::codegen> backend(create_codegen(static_cast<backend_type>(type), options));
+
+		reshadefx::parser parser;
+		backend_result.success = parser.parse(pp.output(), backend.get());
+
+		reshadefx::module module;
+		if (backend_result.success)
+			backend->write_result(module);
+
+		backend_result.milliseconds = elapsed_milliseconds(start);
+		backend_result.output_size = type == backend_spirv ? module.spirv.size() * sizeof(uint32_t) : module.hlsl.size();
+
+		result.success &= backend_result.success;
+
+		// Most diagnostics are the same for every backend, so only add those that differ from the previous one
+		if (parser.errors() != previous_parser_errors)
+		{
+			result.errors += parser.errors();
+			previous_parser_errors = std::move(parser.errors());
+		}
+	}
+}
+
+static std::string escape_json(const std::string &s)
+{
+	std::string escaped;
+	escaped.reserve(s.size() + 2);
+	escaped += '\"';
+	for (const char c : s)
+	{
+		if (c == '\"' || c == '\\')
+			escaped += '\\', escaped += c;
+		else if (c == '\t')
+			escaped += "\\t";
+		else if (static_cast<unsigned char>(c) >= 0x20)
+			escaped += c;
+	}
+	escaped += '\"';
+	return escaped;
+}
+
+static std::string write_report(const std::vector<std::filesystem::path> &inputs, const std::vector<compile_result> &results, double total_milliseconds)
+{
+	char buf[128];
+	size_t num_failed = 0;
+
+	std::string json = "{\n\t\"version\": \"" VERSION_STRING_PRODUCT "\",\n\t\"files\": [";
+
+	for (size_t i = 0; i < inputs.size(); ++i)
+	{
+		const compile_result &result = results[i];
+
+		if (!result.success)
+			num_failed++;
+
+		// Split diagnostics into lines and count them by their severity
+		std::string diagnostics;
+		size_t num_errors = 0, num_warnings = 0;
+		for (size_t offset = 0, next; offset < result.errors.size(); offset = next + 1)
+		{
+			if (next = result.errors.find('\n', offset); next == std::string::npos)
+				next = result.errors.size();
+			if (next == offset)
+				continue;
+
+			const std::string line = result.errors.substr(offset, next - offset);
+			if (line.find(": error") != std::string::npos || line.find(": preprocessor error") != std::string::npos)
+				num_errors++;
+			else if (line.find(": warning") != std::string::npos || line.find(": preprocessor warning") != std::string::npos)
+				num_warnings++;
+
+			if (!diagnostics.empty())
+				diagnostics += ',';
+			diagnostics += "\n\t\t\t\t" + escape_json(line);
+		}
+
+		json += i == 0 ? "\n" : ",\n";
+		json += "\t\t{\n\t\t\t\"path\": " + escape_json(inputs[i].u8string());
+		json += ",\n\t\t\t\"success\": ";
+		json += result.success ? "true" : "false";
+		json += ",\n\t\t\t\"errors\": " + std::to_string(num_errors);
+		json += ",\n\t\t\t\"warnings\": " + std::to_string(num_warnings);
+		json += ",\n\t\t\t\"diagnostics\": [" + diagnostics + (diagnostics.empty() ? "]" : "\n\t\t\t]");
+
+		snprintf(buf, sizeof(buf), ",\n\t\t\t\"preprocess\": { \"milliseconds\": %.3f, \"output_size\": %zu }", result.preprocess_milliseconds, result.preprocessed_size);
+		json += buf;
+
+		for (int type = 0; type < backend_count; ++type)
+		{
+			const compile_result::backend_result &backend_result = result.backends[type];
+			if (!backend_result.compiled)
+				continue;
+
+			snprintf(buf, sizeof(buf), ",\n\t\t\t\"%s\": { \"success\": %s, \"milliseconds\": %.3f, \"output_size\": %zu }",
+				s_backend_names[type],
+				backend_result.success ? "true" : "false",
+				backend_result.milliseconds,
+				backend_result.output_size);
+			json += buf;
+		}
+
+		json += "\n\t\t}";
+	}
+
+	snprintf(buf, sizeof(buf), "\n\t],\n\t\"succeeded\": %zu,\n\t\"failed\": %zu,\n\t\"milliseconds\": %.3f\n}\n", inputs.size() - num_failed, num_failed, total_milliseconds);
+	json += buf;
+
+	return json;
+}
+
 int main(int argc, char *argv[])
 {
-	const char *filename = nullptr;
+	std::vector<std::filesystem::path> inputs;
 	const char *preprocess = nullptr;
 	const char *errorfile = nullptr;
 	const char *objectfile = nullptr;
+	const char *reportfile = nullptr;
 	const char *buffer_width = "800";
 	const char *buffer_height = "600";
-	bool print_glsl = false;
-	bool print_hlsl = false;
-	bool debug_info = false;
-	bool invert_y_axis = false;
-	bool spec_constants = false;
-	unsigned int shader_model = 50;
+	unsigned int num_threads = 1;
 
-	reshadefx::parser parser;
-	reshadefx::preprocessor pp;
-	pp.add_macro_definition("__RESHADE__", std::to_string(VERSION_MAJOR * 10000 + VERSION_MINOR * 100 + VERSION_REVISION));
-	pp.add_macro_definition("__RESHADE_PERFORMANCE_MODE__", "0");
+	compile_options options;
+	options.macros.emplace_back("__RESHADE__", std::to_string(VERSION_MAJOR * 10000 + VERSION_MINOR * 100 + VERSION_REVISION));
+	options.macros.emplace_back("__RESHADE_PERFORMANCE_MODE__", "0");
 
 	// Parse command-line arguments
 	for (int i = 1; i < argc; ++i)
@@ -78,29 +353,35 @@ int main(int argc, char *argv[])
 
 			if (0 == std::strcmp(arg, "-D"))
 			{
+				if (i + 1 >= argc)
+					continue;
 				char *macro = argv[++i];
 				char *value = std::strchr(macro, '=');
 				if (value) *value++ = '\0';
-				pp.add_macro_definition(macro, value ? value : "1");
+				options.macros.emplace_back(macro, value ? value : "1");
 				continue;
 			}
 
 			if (0 == std::strcmp(arg, "-I"))
 			{
-				pp.add_include_path(argv[++i]);
+				if (i + 1 >= argc)
+					continue;
+				options.include_paths.push_back(std::filesystem::u8path(argv[++i]));
 				continue;
 			}
 
 			if (0 == std::strcmp(arg, "-Zi"))
-				debug_info = true;
+				options.debug_info = true;
 			else if (0 == std::strcmp(arg, "--glsl"))
-				print_glsl = true;
+				options.backends[backend_glsl] = true;
 			else if (0 == std::strcmp(arg, "--hlsl"))
-				print_hlsl = true;
+				options.backends[backend_hlsl] = true;
+			else if (0 == std::strcmp(arg, "--spirv"))
+				options.backends[backend_spirv] = true;
 			else if (0 == std::strcmp(arg, "--invert-y"))
-				invert_y_axis = true;
+				options.invert_y_axis = true;
 			else if (0 == std::strcmp(arg, "--spec-constants"))
-				spec_constants = true;
+				options.spec_constants = true;
 
 			if (i + 1 >= argc)
 				continue;
@@ -111,82 +392,164 @@ int main(int argc, char *argv[])
 			else if (0 == std::strcmp(arg, "-Fo"))
 				objectfile = argv[++i];
 			else if (0 == std::strcmp(arg, "--shader-model"))
-				shader_model = std::strtol(argv[++i], nullptr, 10);
+				options.shader_model = std::strtol(argv[++i], nullptr, 10);
 			else if (0 == std::strcmp(arg, "--width"))
 				buffer_width = argv[++i];
 			else if (0 == std::strcmp(arg, "--height"))
 				buffer_height = argv[++i];
+			else if (0 == std::strcmp(arg, "-j"))
+				num_threads = std::strtoul(argv[++i], nullptr, 10);
+			else if (0 == std::strcmp(arg, "--json"))
+				reportfile = argv[++i];
 		}
 		else
 		{
-			if (filename != nullptr)
+			if (!expand_input(arg, inputs))
 			{
-				std::cout << "error: More than one input file specified" << std::endl;
-				return 1;
+				std::cout << "error: No input files match '" << arg << '\'' << std::endl;
+				return 2;
 			}
-
-			filename = arg;
 		}
 	}
 
-	if (filename == nullptr)
+	if (inputs.empty())
 	{
 		print_usage(argv[0]);
-		return 1;
+		return 2;
 	}
 
-	pp.add_macro_definition("BUFFER_WIDTH", buffer_width);
-	pp.add_macro_definition("BUFFER_HEIGHT", buffer_height);
-	pp.add_macro_definition("BUFFER_RCP_WIDTH", "(1.0 / BUFFER_WIDTH)");
-	pp.add_macro_definition("BUFFER_RCP_HEIGHT", "(1.0 / BUFFER_HEIGHT)");
+	options.macros.emplace_back("BUFFER_WIDTH", buffer_width);
+	options.macros.emplace_back("BUFFER_HEIGHT", buffer_height);
+	options.macros.emplace_back("BUFFER_RCP_WIDTH", "(1.0 / BUFFER_WIDTH)");
+	options.macros.emplace_back("BUFFER_RCP_HEIGHT", "(1.0 / BUFFER_HEIGHT)");
 
-	if (!pp.append_file(filename))
+	// Compile a single input the same way as always, so that code can be printed or written to a file
+	if (inputs.size() == 1 && reportfile == nullptr)
 	{
-		if (errorfile == nullptr)
-			std::cout << pp.errors() << std::endl;
-		else
-			std::ofstream(errorfile) << pp.errors();
-		return 1;
-	}
+		reshadefx::parser parser;
+		reshadefx::preprocessor pp;
+		setup_preprocessor(pp, options);
+
+		if (!pp.append_file(inputs[0]))
+		{
+			if (errorfile == nullptr)
+				std::cout << pp.errors() << std::endl;
+			else
+				std::ofstream(errorfile) << pp.errors();
+			return 1;
+		}
+
+		if (preprocess != nullptr)
+		{
+			if (std::strcmp(preprocess, "-") == 0)
+				std::cout << pp.output() << std::endl;
+			else
+				std::ofstream(preprocess) << pp.output();
+			return 0;
+		}
+
+		const bool print_glsl = options.backends[backend_glsl];
+		const bool print_hlsl = options.backends[backend_hlsl];
+
+		const std::unique_ptr<reshadefx::codegen> backend(create_codegen(print_glsl ? backend_glsl : print_hlsl ? backend_hlsl : backend_spirv, options));
+
+		if (!parser.parse(pp.output(), backend.get()))
+		{
+			if (errorfile == nullptr)
+				std::cout << pp.errors() << parser.errors() << std::endl;
+			else
+				std::ofstream(errorfile) << pp.errors() << parser.errors();
+			return 1;
+		}
+
+		reshadefx::module module;
+		backend->write_result(module);
+
+		if (print_glsl || print_hlsl)
+		{
+			std::cout << module.hlsl << std::endl;
+		}
+		else if (objectfile != nullptr)
+		{
+			std::ofstream(objectfile, std::ios::binary).write(
+				reinterpret_cast<const char *>(module.spirv.data()), module.spirv.size() * sizeof(uint32_t));
+		}
 
-	if (preprocess != nullptr)
-	{
-		if (std::strcmp(preprocess, "-") == 0)
-			std::cout << pp.output() << std::endl;
-		else
-			std::ofstream(preprocess) << pp.output();
 		return 0;
 	}
 
-	std::unique_ptr<reshadefx::codegen> backend;
-	if (print_glsl)
-		backend.reset(reshadefx::create_codegen_glsl(debug_info, spec_constants));
-	else if (print_hlsl)
-		backend.reset(reshadefx::create_codegen_hlsl(shader_model, debug_info, spec_constants));
-	else
-		backend.reset(reshadefx::create_codegen_spirv(true, debug_info, spec_constants, invert_y_axis));
-
-	if (!parser.parse(pp.output(), backend.get()))
+	if (preprocess != nullptr || objectfile != nullptr)
 	{
-		if (errorfile == nullptr)
-			std::cout << pp.errors() << parser.errors() << std::endl;
-		else
-			std::ofstream(errorfile) << pp.errors() << parser.errors();
-		return 1;
+		std::cout << "error: '-P' and '-Fo' cannot be used with multiple input files or '--json'" << std::endl;
+		return 2;
 	}
 
-	reshadefx::module module;
-	backend->write_result(module);
+	// Validate with every backend if none was selected explicitly
+	if (std::find(std::begin(options.backends), std::end(options.backends), true) == std::end(options.backends))
+		std::fill(std::begin(options.backends), std::end(options.backends), true);
+
+	if (num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	num_threads = std::min(num_threads, static_cast<unsigned int>(inputs.size()));
+
+	// Share file contents between all inputs, so that common headers are only read once
+	reshadefx::preprocessor::include_cache include_cache;
+
+	std::vector<compile_result> results(inputs.size());
+	std::atomic<size_t> next_input = 0;
+
+	const auto compile_start = std::chrono::high_resolution_clock::now();
+
+	const auto worker = [&]() {
+		for (size_t i; (i = next_input++) < inputs.size();)
+			compile_file(inputs[i], options, include_cache, results[i]);
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads - 1);
+	for (unsigned int i = 1; i < num_threads; ++i)
+		threads.emplace_back(worker);
+	worker();
+	for (std::thread &thread : threads)
+		thread.join();
+
+	const double total_milliseconds = elapsed_milliseconds(compile_start);
 
-	if (print_glsl || print_hlsl)
+	// Print diagnostics in input order, independent of the order in which inputs finished compiling
+	std::string errors;
+	size_t num_failed = 0;
+	for (const compile_result &result : results)
 	{
-		std::cout << module.hlsl << std::endl;
+		errors += result.errors;
+		if (!result.success)
+			num_failed++;
 	}
-	else if (objectfile != nullptr)
+
+	const bool report_to_stdout = reportfile != nullptr && std::strcmp(reportfile, "-") == 0;
+
+	// Diagnostics are part of the report already, so do not mix them into it when it is written to standard output
+	if (errorfile != nullptr)
+		std::ofstream(errorfile) << errors;
+	else if (!report_to_stdout)
+		std::cout << errors;
+
+	if (reportfile != nullptr)
 	{
-		std::ofstream(objectfile, std::ios::binary).write(
-			reinterpret_cast<const char *>(module.spirv.data()), module.spirv.size() * sizeof(uint32_t));
+		const std::string report = write_report(inputs, results, total_milliseconds);
+
+		if (report_to_stdout)
+		{
+			std::cout << report;
+		}
+		else if (!(std::ofstream(reportfile) << report))
+		{
+			std::cout << "error: Failed to write report to " << reportfile << std::endl;
+			return 2;
+		}
 	}
 
-	return 0;
+	if (!report_to_stdout)
+		printf("%zu of %zu files compiled successfully in %.1f ms\n", inputs.size() - num_failed, inputs.size(), total_milliseconds);
+
+	return num_failed != 0 ? 1 : 0;
 }